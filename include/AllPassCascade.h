@@ -0,0 +1,131 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "Simd.h"
+#include "StateBuffer.h"
+
+
+// The fixed all-pass filter of the talkbox, used as carrier pre-filter
+// and as output post-filter. Per sample and lane:
+//
+//      p  = d0 + h0 * c;    d0 = d1;  d1 = c  - h0 * p;
+//      q  = d2 + h1 * d4;   d2 = d3;  d3 = d4 - h1 * q;
+//      d4 = c;              y  = p + q;
+//
+// with h0 = 0.3, h1 = 0.77. It "smears" the phase, which thickens the
+// carrier and makes the result less buzzy.
+//
+// Lanes independent streams (stereo carrier, several engine instances,
+// several carriers) run side by side in SIMD registers: groups of 8 lanes
+// with AVX, 4 with SSE/NEON, the rest one at a time. Every lane performs
+// exactly the scalar arithmetic above, so a lane's output is bit-exact
+// with AllPassCascade<1> (and with the old scalar code in processBlock())
+// as long as the compiler does not contract the scalar code into FMAs.
+template <int32_t Lanes>
+class AllPassCascade {
+    public:
+        static constexpr float h0 = 0.3f;
+        static constexpr float h1 = 0.77f;
+
+        // Clear the state of every lane
+        void reset() {
+            memset(d0_, 0, sizeof(d0_)); memset(d1_, 0, sizeof(d1_));
+            memset(d2_, 0, sizeof(d2_)); memset(d3_, 0, sizeof(d3_));
+            memset(d4_, 0, sizeof(d4_));
+        }
+
+        // Interleaved streams: in[i * Lanes + l] is sample i of lane l.
+        // 'out' may be the same buffer as 'in'.
+        void process(const float* in, float* out, int32_t n) {
+            int32_t l = 0;
+#if defined(TALKBOX_SIMD_AVX)
+            for (; l + 8 <= Lanes; l += 8) run<__m256>(l, in, out, n);
+#endif
+#if defined(TALKBOX_SIMD_AVX) || defined(TALKBOX_SIMD_SSE)
+            for (; l + 4 <= Lanes; l += 4) run<__m128>(l, in, out, n);
+#elif defined(TALKBOX_SIMD_NEON)
+            for (; l + 4 <= Lanes; l += 4) run<float32x4_t>(l, in, out, n);
+#endif
+            for (; l < Lanes; l++) run<float>(l, in, out, n);
+        }
+
+        // Planar streams: in[l][i] is sample i of lane l. Goes through a
+        // small interleaved buffer so the lanes still run in SIMD.
+        void process(const float* const* in, float* const* out, int32_t n) {
+            constexpr int32_t CHUNK = 64;
+            float tmp[CHUNK * Lanes];
+
+            for (int32_t done = 0; done < n; done += CHUNK)
+            {
+                int32_t m = (n - done < CHUNK) ? n - done : CHUNK;
+                for (int32_t i = 0; i < m; i++)
+                    for (int32_t l = 0; l < Lanes; l++) tmp[i * Lanes + l] = in[l][done + i];
+
+                process(tmp, tmp, m);
+
+                for (int32_t i = 0; i < m; i++)
+                    for (int32_t l = 0; l < Lanes; l++) out[l][done + i] = tmp[i * Lanes + l];
+            }
+        }
+
+        // Denormal guard, per lane: zero any of the decaying states d0..d3
+        // whose magnitude is below 'threshold'. d4 is an input snapshot and
+        // is left alone, as in the original code.
+        void flushDenormals(float threshold = 1.0e-10f) {
+            int32_t l = 0;
+#if defined(TALKBOX_SIMD_AVX)
+            for (; l + 8 <= Lanes; l += 8) flush<__m256>(l, threshold);
+#endif
+#if defined(TALKBOX_SIMD_AVX) || defined(TALKBOX_SIMD_SSE)
+            for (; l + 4 <= Lanes; l += 4) flush<__m128>(l, threshold);
+#elif defined(TALKBOX_SIMD_NEON)
+            for (; l + 4 <= Lanes; l += 4) flush<float32x4_t>(l, threshold);
+#endif
+            for (; l < Lanes; l++) flush<float>(l, threshold);
+        }
+
+        // Copy the state of every lane out / back in (TalkBoxProcessor snapshots)
+        void saveState(StateWriter& w) const {
+            w.put(d0_, Lanes); w.put(d1_, Lanes); w.put(d2_, Lanes); w.put(d3_, Lanes); w.put(d4_, Lanes);
+        }
+        void restoreState(StateReader& r) {
+            r.get(d0_, Lanes); r.get(d1_, Lanes); r.get(d2_, Lanes); r.get(d3_, Lanes); r.get(d4_, Lanes);
+        }
+
+    private:
+        // Lanes l .. l + width-1 over n samples, state kept in registers
+        template <typename V>
+        void run(int32_t l, const float* in, float* out, int32_t n) {
+            using Op = SimdOps<V>;
+            const V H0 = Op::set1(h0);
+            const V H1 = Op::set1(h1);
+            V d0 = Op::load(d0_ + l), d1 = Op::load(d1_ + l), d2 = Op::load(d2_ + l);
+            V d3 = Op::load(d3_ + l), d4 = Op::load(d4_ + l);
+
+            for (int32_t i = 0; i < n; i++)
+            {
+                V c = Op::load(in + i * Lanes + l);
+                V p = Op::add(d0, Op::mul(H0, c));
+                d0 = d1;  d1 = Op::sub(c, Op::mul(H0, p));
+                V q = Op::add(d2, Op::mul(H1, d4));
+                d2 = d3;  d3 = Op::sub(d4, Op::mul(H1, q));
+                d4 = c;
+                Op::store(out + i * Lanes + l, Op::add(p, q));
+            }
+
+            Op::store(d0_ + l, d0); Op::store(d1_ + l, d1); Op::store(d2_ + l, d2);
+            Op::store(d3_ + l, d3); Op::store(d4_ + l, d4);
+        }
+
+        template <typename V>
+        void flush(int32_t l, float threshold) {
+            using Op = SimdOps<V>;
+            Op::store(d0_ + l, Op::flush(Op::load(d0_ + l), threshold));
+            Op::store(d1_ + l, Op::flush(Op::load(d1_ + l), threshold));
+            Op::store(d2_ + l, Op::flush(Op::load(d2_ + l), threshold));
+            Op::store(d3_ + l, Op::flush(Op::load(d3_ + l), threshold));
+        }
+
+        // Filter state, one entry per lane
+        float d0_[Lanes] = {0}, d1_[Lanes] = {0}, d2_[Lanes] = {0}, d3_[Lanes] = {0}, d4_[Lanes] = {0};
+};
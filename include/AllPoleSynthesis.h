@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+
+// LPC synthesis kernels: the all-pole filter 1/A(z) driven by G * carrier.
+//
+// The mda lattice (lattice_synth) is the reference. AllPoleFilter runs the
+// same filter in direct form,
+//      y[i] = G * car[i] - sum_{j=1}^{order} a[j] * y[i-j]
+// with the predictor coefficients a[] derived from the reflection
+// coefficients once per frame. Both start every frame from zero state.
+
+// Largest order the direct-form filter supports. The history in front of
+// the output buffer must have this many floats (see AllPoleFilter::process).
+static constexpr int32_t ALLPOLE_PAD = 64;
+
+
+// Reference lattice filter: the original per-sample loop from lpc().
+// 'out' may alias 'car'.
+void lattice_synth(const float* k, int32_t order, float G,
+                   const float* car, float* out, int32_t n);
+
+// Step-up recursion: reflection coefficients k[1..order] to direct-form
+// predictor coefficients a[1..order] (a[0] = 1), same convention as lpc_durbin().
+void reflection_to_predictor(const float* k, int32_t order, float* a);
+
+// Step-down recursion: predictor a[1..order] back to reflection coefficients.
+// Returns false if any recovered |k| >= 1, i.e. 1/A(z) is not stable.
+bool predictor_to_reflection(const float* a, int32_t order, float* k);
+
+
+// Direct-form all-pole filter with a block ("look-ahead") formulation.
+//
+// Outputs are produced four at a time. For each group the contributions of
+// the already known history are four dot products over the same window of
+// y[], computed together with SIMD (one history load feeds four
+// coefficient rows); the few terms that couple the four new outputs are
+// then resolved with a short scalar triangular step. This removes the
+// order_-long serial chain of the lattice, where each stage waits for the
+// previous one.
+class AllPoleFilter {
+    public:
+        // Convert the (clamped) reflection coefficients for this frame.
+        // Returns false if the float direct-form polynomial fails the
+        // stability check: stepping a[] back down must give |k| < 1 and
+        // reproduce the lattice coefficients within 'tolerance'. In that
+        // case the caller should run lattice_synth() for this frame.
+        bool setCoeffs(const float* k, int32_t order, float tolerance = 1.0e-3f);
+
+        // Filter n samples. 'y' must have ALLPOLE_PAD writable floats in
+        // front of it (y[-ALLPOLE_PAD..-1]); they are zeroed and used as the
+        // initial history. y must not alias car.
+        void process(float G, const float* car, float* y, int32_t n) const;
+
+        int32_t order() const { return order_; }
+
+    private:
+        int32_t order_ = 0;
+        int32_t len_   = 0;                 // order rounded up to the SIMD width
+        float   a_[ALLPOLE_PAD + 1];        // predictor, a_[0] = 1
+        float   rows_[4][ALLPOLE_PAD];      // right-aligned reversed a[], one row per output of a group
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include "StateBuffer.h"
+
+
+// Autocorrelation kernels for the LPC analysis.
+//
+// Every kernel computes the (biased, un-normalized) autocorrelation
+//      r[j] = sum_{i=0}^{n-1-j} x[i] * x[i+j]       for j = 0..maxLag
+// so the caller must provide room for maxLag+1 values in r[].
+// Lags with j >= n are set to zero.
+
+// Scalar reference: the original mda loop, one lag at a time.
+// Kept as the bit-exact reference for the faster kernels.
+void autocorr_scalar(const float* x, int32_t n, int32_t maxLag, float* r);
+
+// Register-tiled kernel: computes 4 lags per pass over x[], so each
+// x[i] is loaded once and reused by four accumulators. Uses SSE/AVX
+// (or NEON) when available, plain scalar tiling otherwise.
+// Results differ from autocorr_scalar() only by float summation order.
+void autocorr_tiled(const float* x, int32_t n, int32_t maxLag, float* r);
+
+// Default kernel used by the engine.
+inline void autocorr(const float* x, int32_t n, int32_t maxLag, float* r)
+{
+    autocorr_tiled(x, n, maxLag, r);
+}
+
+
+// FFT-based autocorrelation backend.
+//
+// The frame is zero-padded to a power of two M >= n + maxLag (so the
+// circular correlation has no wrap-around for the lags we need), then
+//      r = IFFT( |FFT(x)|^2 )
+// using a real FFT packed into a complex FFT of size M/2.
+// Cost is O(M log M) instead of O(n * maxLag) for the direct kernels.
+//
+// All memory is allocated in the constructor for the largest frame;
+// init() and compute() never allocate, so compute() is safe to call
+// from the audio callback.
+//
+// Accuracy: in single precision the lags match the direct loop within
+//      |r_fft[j] - r_direct[j]| <= 1e-5 * r[0]
+// (rounding of the FFT grows with log2(M), not with the frame length).
+class FftAutocorrelator {
+    public:
+        FftAutocorrelator(int32_t maxN, int32_t maxLag);
+        ~FftAutocorrelator();
+
+        // Select the FFT size for frames of up to n samples and lags up to maxLag.
+        // Must be called (from the non-realtime init) before compute().
+        void init(int32_t n, int32_t maxLag);
+
+        // Same contract as autocorr(). Falls back to the direct kernel if
+        // n + maxLag does not fit the size selected in init().
+        void compute(const float* x, int32_t n, int32_t maxLag, float* r);
+
+        int32_t size() const { return size_; }
+
+    private:
+        void fft(float* re, float* im) const;     // in-place forward complex FFT of size size_/2
+
+        int32_t maxSize_ = 0;   // largest M the buffers can hold
+        int32_t size_    = 0;   // current real FFT size M
+        float*   re_;           // complex work buffer (M/2 + 1)
+        float*   im_;
+        float*   cos_;          // cos(2*pi*k/M), k < M/2
+        float*   sin_;          // sin(2*pi*k/M), k < M/2
+        int32_t* bitrev_;       // bit-reversal permutation for M/2 points
+};
+
+
+// Recursive (exponentially windowed) autocorrelation, after Barnwell.
+//
+// Instead of windowing a whole frame, every lag is updated on each new
+// sample through two cascaded one-pole sections:
+//      s[j](n) = alpha * s[j](n-1) + x(n) * x(n-j)
+//      r[j](n) = alpha * r[j](n-1) + s[j](n)
+// which is the same as weighting the lagged products with the window
+// w(m) = (m+1) * alpha^m. The window sums to 1/(1-alpha)^2 and its centre
+// of mass sits about 2/(1-alpha) samples in the past.
+//
+// Windowing the products (rather than the signal) does not by itself give
+// a positive definite Toeplitz matrix: each one-pole stage equals the
+// autocorrelation of the signal windowed by alpha^(m/2), times alpha^(-j/2).
+// read() multiplies lag j by alpha^(j/2), which turns r[] back into a
+// positive weighted sum of true autocorrelations, so Durbin always sees a
+// valid (minimum-phase) problem. Without it quiet passages drive |k| to 1.
+//
+// Cost is a constant 2*(maxLag+1) multiply-adds per sample, with no burst
+// at frame boundaries. Buffers are allocated in the constructor.
+class RecursiveAutocorrelator {
+    public:
+        explicit RecursiveAutocorrelator(int32_t maxLag);
+        ~RecursiveAutocorrelator();
+
+        // Set the window pole and clear the state
+        void init(float alpha);
+        void reset();
+
+        // Add one sample
+        void push(float x);
+
+        // Copy r[0..maxLag] multiplied by 'scale'. Also flushes decayed
+        // state to zero so long silences don't end up in denormals.
+        void read(float* r, int32_t maxLag, float scale);
+
+        // Copy the running state out / back in (TalkBoxProcessor snapshots)
+        void saveState(StateWriter& w) const;
+        void restoreState(StateReader& r);
+
+    private:
+        int32_t lags_;          // maxLag + 1
+        int32_t pos_ = 0;       // newest sample in hist_
+        float   alpha_ = 0.99f;
+        float*  hist_;          // last lags_ samples, stored twice so they are contiguous from pos_
+        float*  s_;             // first recursive section
+        float*  r_;             // second recursive section (the autocorrelation)
+        float*  lagwin_;        // alpha^(j/2) correction
+};
@@ -0,0 +1,285 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "TalkBoxProcessor.h"
+#include "LpcLanes.h"
+#include "AllPassCascade.h"
+#include "DenormalGuard.h"
+#include "Simd.h"
+
+
+// 'Voices' modulators (e.g. several singers) through one shared carrier.
+//
+// With one TalkBoxProcessor per voice the carrier is pre-filtered, and its
+// two OLA frames buffered, once per voice, although every copy is the same.
+// Here the carrier side runs once: a single pre-filter and the mono carrier
+// frames car0_/car1_. Each voice keeps its own modulator path in SIMD lanes
+// like TalkBoxBank (emphasis, window/OLA, gender, LPC, post-filter), and its
+// lattice reads the shared carrier frame directly (a broadcast instead of a
+// per-lane load).
+//
+// Voices share the sample rate, hence the frame boundaries; wet/dry/
+// quality/gender are per voice (updateParams(voice, ...)). The lattice runs
+// at the highest order, a voice with a lower order gets k = 0 on the extra
+// stages. Output is either one buffer pair per voice (processBlock()) or the
+// sum of all voices (processBlockMixed()).
+//
+// With setDenormalMode(DenormalMode::Clamp) every voice is bit-exact with a
+// TalkBoxCore<float, float> fed its modulator and the shared carrier, as
+// long as the compiler does not contract the scalar code into FMAs. Under
+// the default Flush mode the voices only differ from it where a value would
+// have gone denormal, i.e. by ~1e-10.
+template <int32_t Voices>
+class ChoirTalkBox {
+    public:
+        static constexpr int32_t voices = Voices;
+
+        // Lanes actually processed: with SIMD the voice count is padded to a
+        // multiple of 4 with silent voices (see MultiCarrierTalkBox)
+        static constexpr int32_t LANES = (Voices > 1 && TALKBOX_SIMD_WIDTH > 1) ? (Voices + 3) / 4 * 4 : Voices;
+
+        ChoirTalkBox() {
+            buf0_   = new float[BUF_MAX * LANES];
+            buf1_   = new float[BUF_MAX * LANES];
+            gbuf_   = new float[BUF_MAX * LANES];
+            car0_   = new float[BUF_MAX];
+            car1_   = new float[BUF_MAX];
+            window_ = new float[BUF_MAX];
+            memset(buf0_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(buf1_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(car0_, 0, sizeof(float) * BUF_MAX);
+            memset(car1_, 0, sizeof(float) * BUF_MAX);
+            memset(mod_, 0, sizeof(mod_));      // padding lanes stay silent
+            std::fill(gender_, gender_ + LANES, 0.5f);
+        }
+
+        ~ChoirTalkBox() {
+            delete[] buf0_; delete[] buf1_;
+            delete[] car0_; delete[] car1_;
+            delete[] gbuf_;
+            delete[] window_;
+        }
+
+        ChoirTalkBox(const ChoirTalkBox&) = delete;
+        ChoirTalkBox& operator=(const ChoirTalkBox&) = delete;
+
+        // Update the parameters of one voice, or of all of them
+        void updateParams(int32_t voice, const TalkBoxParams& params) {
+            order_[voice]  = talkbox_order(fs_, params.quality);
+            wet_[voice]    = 0.5f * params.wet * params.wet;
+            dry_[voice]    = 2.0f * params.dry * params.dry;
+            gender_[voice] = params.gender;
+            max_order_     = *std::max_element(order_, order_ + LANES);
+        }
+
+        void updateParams(const TalkBoxParams& params) {
+            for (int32_t v = 0; v < Voices; v++) updateParams(v, params);
+        }
+
+        // Select the denormal handling (default: Flush), as TalkBoxProcessor
+        void setDenormalMode(DenormalMode mode) { denormal_mode_ = mode; }
+
+        // Initialize engine: must call before processing
+        void init(float sampleRate, const TalkBoxParams& params) {
+            fs_ = std::clamp(sampleRate, 8000.0f, 96000.0f);
+            N_  = talkbox_frame_length(fs_);
+
+            talkbox_hann_window(window_, N_);
+
+            updateParams(params);
+
+            p0_ = 0;
+            p1_ = N_ / 2;
+            K_  = 0;
+            memset(emph_, 0, sizeof(emph_));
+            memset(fx_, 0, sizeof(fx_));
+            prefilter_.reset();
+            postfilter_.reset();
+
+            // Empty frames, so a re-initialized engine starts like a new one
+            memset(buf0_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(buf1_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(car0_, 0, sizeof(float) * BUF_MAX);
+            memset(car1_, 0, sizeof(float) * BUF_MAX);
+        }
+
+        // Process a block of `frames` samples: modIn[v], outL[v] and outR[v]
+        // are the mono buffers of voice v, carIn the shared mono carrier
+        void processBlock(const float* const* modIn,
+                            const float* carIn,
+                            float* const* outL,
+                            float* const* outR,
+                            int32_t frames  )
+        {
+            const bool flush = denormal_mode_ == DenormalMode::Flush && ScopedDenormalFlush::supported;
+            ScopedDenormalFlush guard(flush);
+
+            for (int32_t done = 0; done < frames; done += STAGE_BLOCK)
+            {
+                const int32_t n = std::min(STAGE_BLOCK, frames - done);
+                processChunk(modIn, carIn + done, done, n);
+                for (int32_t v = 0; v < Voices; v++)
+                    for (int32_t i = 0; i < n; i++)
+                        outL[v][done + i] = outR[v][done + i] = out_[i * LANES + v];
+            }
+            clampDenormals(flush);
+        }
+
+        // Same, with all voices summed into one mono output
+        void processBlockMixed(const float* const* modIn,
+                                 const float* carIn,
+                                 float* outL,
+                                 float* outR,
+                                 int32_t frames  )
+        {
+            const bool flush = denormal_mode_ == DenormalMode::Flush && ScopedDenormalFlush::supported;
+            ScopedDenormalFlush guard(flush);
+
+            for (int32_t done = 0; done < frames; done += STAGE_BLOCK)
+            {
+                const int32_t n = std::min(STAGE_BLOCK, frames - done);
+                processChunk(modIn, carIn + done, done, n);
+                for (int32_t i = 0; i < n; i++)
+                {
+                    float sum = 0.0f;
+                    for (int32_t v = 0; v < Voices; v++) sum += out_[i * LANES + v];
+                    outL[done + i] = outR[done + i] = sum;
+                }
+            }
+            clampDenormals(flush);
+        }
+
+    private:
+        using Vec = typename SimdLaneVec<LANES>::type;
+        using Op  = typename SimdLaneVec<LANES>::ops;
+        static constexpr int32_t W = Op::width;
+
+        // Clamp mode, or the fallback for targets without the hardware modes
+        void clampDenormals(bool flushed)
+        {
+            if (!flushed)
+            {
+                prefilter_.flushDenormals(1.0e-10f);
+                postfilter_.flushDenormals(1.0e-10f);
+            }
+        }
+
+        // Run n <= STAGE_BLOCK samples; the voices' outputs are left in out_
+        void processChunk(const float* const* modIn, const float* carIn, int32_t off, int32_t n)
+        {
+            // 1. Interleave the voices, pre-filter the carrier once
+            for (int32_t i = 0; i < n; i++)
+                for (int32_t v = 0; v < Voices; v++) mod_[i * LANES + v] = modIn[v][off + i];
+            prefilter_.process(carIn, car_, n);
+
+            // 2. Half-rate analysis/synthesis; the output is held over the
+            // skipped samples
+            for (int32_t i = 0; i < n; i++)
+            {
+                if (K_++)
+                {
+                    K_ = 0;
+                    olaStep(mod_ + i * LANES, car_[i]);
+                }
+                memcpy(out_ + i * LANES, fx_, sizeof(fx_));
+            }
+
+            // 3. Post-filter each voice, mix wet + dry
+            postfilter_.process(out_, out_, n);
+            for (int32_t i = 0; i < n; i++)
+                for (int32_t g = 0; g < LANES; g += W)
+                {
+                    Vec y = Op::mul(Op::load(wet_ + g), Op::load(out_ + i * LANES + g));
+                    y = Op::add(y, Op::mul(Op::load(dry_ + g), Op::load(mod_ + i * LANES + g)));
+                    Op::store(out_ + i * LANES + g, y);
+                }
+        }
+
+        // One decimated sample: the carrier goes into its frames once, every
+        // voice through emphasis, window and overlap-add
+        void olaStep(const float* mod, float car)
+        {
+            car0_[p0_] = car;
+            car1_[p1_] = car;
+
+            float* b0 = buf0_ + p0_ * LANES;
+            float* b1 = buf1_ + p1_ * LANES;
+            const Vec w  = Op::set1(window_[p0_]);
+            const Vec w2 = Op::set1(1.0f - window_[p0_]);
+
+            for (int32_t g = 0; g < LANES; g += W)
+            {
+                Vec m = Op::load(mod + g);
+                Vec e = Op::sub(m, Op::load(emph_ + g));
+                Op::store(emph_ + g, m);
+
+                Vec fx = Op::mul(Op::load(b0 + g), w);
+                Op::store(b0 + g, Op::mul(e, w));
+                fx = Op::add(fx, Op::mul(Op::load(b1 + g), w2));
+                Op::store(b1 + g, Op::mul(e, w2));
+                Op::store(fx_ + g, fx);
+            }
+
+            if (++p0_ >= N_) { lpcFrame(buf0_, car0_); p0_ = 0; }
+            if (++p1_ >= N_) { lpcFrame(buf1_, car1_); p1_ = 0; }
+        }
+
+        // LPC of every voice's frame, then each voice's lattice filters the
+        // shared carrier frame in place of its analysed buffer
+        void lpcFrame(float* buf, const float* car)
+        {
+            const int32_t n = N_;
+            const int32_t o = max_order_;
+            bool silent[LANES];
+
+            bool anyVoiced = lpc_analyze_lanes<LANES>(buf, n, order_, o, gender_, gbuf_, r_, k_, G_, silent);
+
+            if (anyVoiced) lattice_lanes<LANES, true>(k_, G_, o, car, buf, n, z_);
+            for (int32_t l = 0; l < LANES; l++)
+                if (silent[l])
+                    for (int32_t i = 0; i < n; i++) buf[i * LANES + l] = 0.0f;
+        }
+
+        // Per-voice overlap-add buffers, [sample * LANES + voice]
+        float* buf0_;
+        float* buf1_;
+        float* gbuf_;       // gender-resampled frame
+        float* window_;
+
+        // Shared carrier frames
+        float* car0_;
+        float* car1_;
+
+        // Chunk buffers
+        float mod_[STAGE_BLOCK * LANES];
+        float out_[STAGE_BLOCK * LANES];
+        float car_[STAGE_BLOCK];
+
+        // LPC of the current frame, [coefficient * LANES + voice]
+        float r_[ORD_MAX * LANES];
+        float k_[ORD_MAX * LANES];
+        float z_[ORD_MAX * LANES];
+        float G_[LANES];
+
+        // Per-voice parameters and state
+        int32_t order_[LANES] = {0};
+        int32_t max_order_ = 0;
+        float wet_[LANES] = {0};
+        float dry_[LANES] = {0};
+        float gender_[LANES];
+        float emph_[LANES] = {0};
+        float fx_[LANES] = {0};
+
+        // Shared processing state
+        int32_t N_ = 0;
+        int32_t p0_ = 0;
+        int32_t p1_ = 0;
+        int32_t K_ = 0;
+        float fs_ = 48000.0f;
+        DenormalMode denormal_mode_ = DenormalMode::Flush;
+
+        AllPassCascade<1> prefilter_;
+        AllPassCascade<LANES> postfilter_;
+};
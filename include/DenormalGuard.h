@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+
+// Scoped flush-to-zero / denormals-are-zero.
+//
+// Denormal (subnormal) floats show up whenever a recursion decays into
+// silence: filter states, the lattice z[], the OLA buffers, a fading
+// carrier. On x86 every operation touching one can cost ~100 cycles, which
+// turns a quiet tail into the most expensive part of the signal.
+//
+// The guard sets the FPU's flush modes for the lifetime of the object and
+// restores the previous control word on exit, so the caller (a DAW host,
+// another plugin, the rest of the firmware) never sees the change:
+//   - x86 SSE:  MXCSR FTZ (bit 15) and DAZ (bit 6)
+//   - AArch64:  FPCR  FZ  (bit 24)
+//   - ARM32 with a VFP (e.g. Cortex-M7 on the Daisy): FPSCR FZ (bit 24)
+// Elsewhere it does nothing and 'supported' is false, so callers can keep a
+// software fallback.
+//
+//      {
+//          ScopedDenormalFlush guard;
+//          ... DSP ...
+//      }   // control word restored here
+//
+// Only the current thread is affected (the control register is per thread).
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define TALKBOX_DENORMAL_SSE 1
+#elif defined(__aarch64__) && defined(__GNUC__)
+    #define TALKBOX_DENORMAL_AARCH64 1
+#elif defined(__arm__) && defined(__ARM_FP) && defined(__GNUC__)
+    #define TALKBOX_DENORMAL_ARM32 1
+#endif
+
+class ScopedDenormalFlush {
+    public:
+#if defined(TALKBOX_DENORMAL_SSE)
+        using Word = uint32_t;
+        static constexpr Word FLUSH_BITS = 0x8040;             // FTZ | DAZ
+        static constexpr bool supported = true;
+#elif defined(TALKBOX_DENORMAL_AARCH64)
+        using Word = uint64_t;
+        static constexpr Word FLUSH_BITS = Word(1) << 24;      // FZ
+        static constexpr bool supported = true;
+#elif defined(TALKBOX_DENORMAL_ARM32)
+        using Word = uint32_t;
+        static constexpr Word FLUSH_BITS = Word(1) << 24;      // FZ
+        static constexpr bool supported = true;
+#else
+        using Word = uint32_t;
+        static constexpr Word FLUSH_BITS = 0;
+        static constexpr bool supported = false;
+#endif
+
+        // 'enable' = false makes the guard a no-op (e.g. to benchmark
+        // against the unguarded code path)
+        explicit ScopedDenormalFlush(bool enable = true) {
+            if (!enable || !supported) return;
+            saved_ = read();
+            // Writing the control register is not free (it serializes on
+            // some CPUs): skip it when the modes are already on
+            if ((saved_ & FLUSH_BITS) != FLUSH_BITS) {
+                write(saved_ | FLUSH_BITS);
+                changed_ = true;
+            }
+        }
+
+        ~ScopedDenormalFlush() {
+            if (changed_) write(saved_);
+        }
+
+        ScopedDenormalFlush(const ScopedDenormalFlush&) = delete;
+        ScopedDenormalFlush& operator=(const ScopedDenormalFlush&) = delete;
+
+    private:
+        static inline Word read() {
+#if defined(TALKBOX_DENORMAL_SSE)
+            return _mm_getcsr();
+#elif defined(TALKBOX_DENORMAL_AARCH64)
+            Word w;
+            __asm__ __volatile__("mrs %0, fpcr" : "=r"(w));
+            return w;
+#elif defined(TALKBOX_DENORMAL_ARM32)
+            Word w;
+            __asm__ __volatile__("vmrs %0, fpscr" : "=r"(w));
+            return w;
+#else
+            return 0;
+#endif
+        }
+
+        static inline void write(Word w) {
+#if defined(TALKBOX_DENORMAL_SSE)
+            _mm_setcsr(w);
+#elif defined(TALKBOX_DENORMAL_AARCH64)
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(w));
+#elif defined(TALKBOX_DENORMAL_ARM32)
+            __asm__ __volatile__("vmsr fpscr, %0" : : "r"(w));
+#else
+            (void)w;
+#endif
+        }
+
+        Word saved_ = 0;
+        bool changed_ = false;
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "TalkBoxTypes.h"
+#include "LpcAnalyzer.h"
+#include "SpscQueue.h"
+
+
+// Moves the LPC analysis of each frame off the audio thread.
+//
+// The audio thread hands every completed (windowed) modulator frame to
+// exchange(): the frame is copied into a job queue, and the coefficients of
+// the *previous* frame come back, computed meanwhile by a worker thread
+// calling service(). The synthesis therefore runs one frame (hop) behind the
+// modulator, and the audio thread only pays for two copies of the frame
+// and the lattice.
+//
+// If the worker has not delivered the previous frame by the time it is
+// needed (missed deadline, or the job queue was full), the audio thread
+// analyses its own copy of that frame instead, with the same code and the
+// settings the frame was queued with; late results are discarded. Either
+// way the same coefficients reach the synthesis, so the output does not
+// depend on the worker's timing.
+//
+// Both queues are wait-free; nothing blocks or allocates after the
+// constructor. init() must not run while a worker is inside service().
+class LpcAnalysisPipe {
+    public:
+        LpcAnalysisPipe();
+        ~LpcAnalysisPipe();
+
+        LpcAnalysisPipe(const LpcAnalysisPipe&) = delete;
+        LpcAnalysisPipe& operator=(const LpcAnalysisPipe&) = delete;
+
+        // Frame length for the sample rate; empties the queues
+        void init(float sampleRate);
+
+        // Audio thread: queue 'frame' (analysed with the settings of
+        // 'local'), and write the coefficients of the previous frame to
+        // 'out' (silent for the first one). 'local' also analyses a missed
+        // frame and collects the order statistics.
+        void exchange(LpcAnalyzer& local, const float* frame, LpcFrameCoeffs& out);
+
+        // Worker thread: analyse one queued frame. Returns false if none was waiting.
+        bool service();
+
+        // Frames analysed on the audio thread because the worker was late
+        uint32_t misses() const { return misses_; }
+
+        // Audio thread, for TalkBoxProcessor snapshots: copy out / back in
+        // the previous frame and its analysis settings, whose coefficients
+        // the next exchange() returns.
+        // After restoreState(), or restart() (no previous frame), results
+        // still in flight belong to the old sequence and are dropped, so the
+        // restored frame is analysed on the audio thread. The worker may keep
+        // running.
+        void saveState(StateWriter& w) const;
+        void restoreState(StateReader& r);
+        void restart();
+
+        // Bytes saveState() writes at frame length N, counted with the same
+        // code; for sizing a pipelined snapshot without a live pipe
+        static size_t stateBytes(int32_t N);
+
+    private:
+        // The analysis settings a frame was captured with
+        struct Settings {
+            int32_t  order = 0;
+            float    gender = 1.0f;
+            AutocorrMethod   autocorr = AutocorrMethod::Direct;
+            ReflectionMethod reflection = ReflectionMethod::Durbin;
+            float    minError = 0.0f;
+        };
+        static Settings capture(const LpcAnalyzer& a);
+        static void apply(const Settings& s, LpcAnalyzer& a);
+
+        static void writeState(StateWriter& w, bool hasPrev, const Settings& settings, const float* prev, int32_t N);
+
+        // A frame for the worker
+        struct Job {
+            uint32_t index;
+            Settings settings;
+            float    x[BUF_MAX];
+        };
+
+        SpscQueue<Job, 4>* jobs_;
+        SpscQueue<LpcFrameCoeffs, 8>* results_;
+        LpcAnalyzer worker_;            // used by service() only
+
+        // Audio thread: copy of the previous frame and its settings, in case
+        // the worker misses it, and the analyzer that then runs them
+        float* prev_;
+        Settings prev_settings_;
+        LpcAnalyzer missed_;
+        int32_t N_ = 0;
+        uint32_t next_index_ = 0;
+        bool has_prev_ = false;
+        uint32_t misses_ = 0;
+};
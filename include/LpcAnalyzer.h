@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include "TalkBoxTypes.h"
+#include "Autocorrelation.h"
+#include "StateBuffer.h"
+
+
+// mda gender (formant shift): resample the n-sample frame 'buf' into 'out'
+// at the rate 1 + (gender - 0.5), linear interpolation, holding the last
+// sample past the end. At the neutral setting nothing is written and it
+// returns false: analyse 'buf' as it is. 'stride' steps through
+// interleaved lanes (LpcLanes); T is the sample type (TalkBoxCore).
+template <typename T>
+bool lpc_gender_resample(const T* buf, int32_t n, T gender, T* out, int32_t stride = 1)
+{
+    T ratio = T(1) + (T(-0.5f) + gender);
+    if (std::abs(ratio - T(1)) < T(0.001f)) return false;
+
+    T read_pos = T(0);
+    for (int32_t i = 0; i < n; i++)
+    {
+        // Clamp read_pos to stay within bounds [0, n-1], hold the last
+        // sample if we read past the end
+        T clamped_pos = std::min(read_pos, static_cast<T>(n - 1));
+        int32_t p0 = static_cast<int32_t>(clamped_pos);
+        T frac = clamped_pos - p0;
+        int32_t p1 = std::min(p0 + 1, n - 1);
+
+        T a = buf[p0 * stride];
+        out[i * stride] = a + frac * (buf[p1 * stride] - a);
+        read_pos += ratio;
+    }
+    return true;
+}
+
+// Modulator side of the talkbox: turns the (decimated) modulator into one
+// LpcFrameCoeffs record per analysis frame.
+//
+// Pre-emphasis, then the same two 50%-overlapped Hann frames as mda: each
+// sample goes into both frames, and whenever one of them is full it runs
+// gender resampling, autocorrelation, the silence check, the reflection
+// recursion and the coefficient clamp. The frames are only read by the
+// analysis; the synthesized audio lives in LpcSynthesizer, which runs the
+// same frame schedule.
+//
+// All memory is allocated in the constructor (BUF_MAX frames, FFT backend
+// for any order below ORD_MAX); init() and the processing never allocate.
+class LpcAnalyzer {
+    public:
+        LpcAnalyzer();
+        ~LpcAnalyzer();
+
+        LpcAnalyzer(const LpcAnalyzer&) = delete;
+        LpcAnalyzer& operator=(const LpcAnalyzer&) = delete;
+
+        // Frame length and window for the sample rate (talkbox_frame_length());
+        // clears the frames, resets the emphasis and the frame counter
+        void init(float sampleRate);
+
+        // LPC order (below ORD_MAX) and gender parameter, at any time
+        void setOrder(int32_t order);
+        void setGender(float gender) { gender_ = gender; }
+        int32_t order() const { return order_; }
+
+        // Autocorrelation backend, reflection recursion, adaptive order
+        // (see the TalkBoxProcessor setters of the same names)
+        void setAutocorrMethod(AutocorrMethod method) { autocorr_method_ = method; }
+        void setReflectionMethod(ReflectionMethod method) { refl_method_ = method; }
+        void setAdaptiveOrder(float minError);
+        AutocorrMethod autocorrMethod() const { return autocorr_method_; }
+        ReflectionMethod reflectionMethod() const { return refl_method_; }
+        float adaptiveOrder() const { return min_error_; }
+        float gender() const { return gender_; }
+
+        // Order actually used per frame since init() or resetOrderStats()
+        const LpcOrderStats& orderStats() const { return order_stats_; }
+        void resetOrderStats() { order_stats_ = LpcOrderStats(); }
+
+        // Add a frame analysed elsewhere (e.g. on a worker) to the statistics
+        void recordFrame(const LpcFrameCoeffs& frame);
+
+        int32_t frameLength() const { return N_; }
+
+        // Pre-emphasis x = m(t) - m(t-1) of 'count' modulator samples;
+        // 'out' may alias 'in'
+        void emphasize(const float* in, float* out, int32_t count);
+
+        // Samples left until the next frame is complete
+        int32_t samplesToFrame() const;
+
+        // Window n <= samplesToFrame() pre-emphasized samples into the
+        // frames. Returns true if they complete a frame, whose LPC is then
+        // written to 'frame'. Same as window() followed by analyze().
+        bool process(const float* e, int32_t n, LpcFrameCoeffs& frame);
+
+        // Window n <= samplesToFrame() pre-emphasized samples into the
+        // frames. Returns the frame they complete (frameLength() samples,
+        // valid until the next call), or nullptr.
+        const float* window(const float* e, int32_t n);
+
+        // LPC of a complete windowed frame: gender resampling,
+        // autocorrelation, then coefficients()
+        void analyze(const float* buf, LpcFrameCoeffs& frame);
+
+        // Coefficients from an autocorrelation r[0..order] (r[0] is
+        // modified): stability fix, silence check, reflection recursion,
+        // clamp. process() runs it on every frame; exposed for analyses
+        // that compute r[] themselves (TalkBoxProcessor Recursive mode).
+        void coefficients(float* r, int32_t order, LpcFrameCoeffs& frame);
+
+        // Copy the frames, write position, emphasis and frame counter out /
+        // back in (TalkBoxProcessor snapshots); the settings and statistics
+        // are not part of it. Same frame length on both sides.
+        void saveState(StateWriter& w) const;
+        void restoreState(StateReader& r);
+
+    private:
+
+        // Analysis frames (windowed, pre-emphasized modulator), the window
+        // and the gender-resampled frame
+        float* buf0_;
+        float* buf1_;
+        float* window_;
+        float* gender_buf_;
+
+        FftAutocorrelator fft_;
+        AutocorrMethod autocorr_method_ = AutocorrMethod::Direct;
+        ReflectionMethod refl_method_ = ReflectionMethod::Durbin;
+        float min_error_ = 0.0f;        // adaptive order threshold, 0 = off
+        LpcOrderStats order_stats_;
+
+        int32_t  N_ = 0;                // frame length
+        int32_t  order_ = 0;
+        int32_t  pos_ = 0;              // write index of buf0_, buf1_ is N_/2 ahead
+        uint32_t frames_ = 0;           // frames produced since init()
+        float gender_ = 0.5f;
+        float emphasis_ = 0.0f;
+};
@@ -0,0 +1,190 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include "TalkBoxProcessor.h"
+#include "LpcRecursion.h"
+#include "Simd.h"
+
+
+// mda LPC kernels on 'Lanes' interleaved channels: sample i of lane l is at
+// [i * Lanes + l], coefficient j of lane l at [j * Lanes + l]. One vector
+// instruction advances 4 (SSE/NEON) or 8 (AVX) lanes; every lane performs
+// exactly the scalar mda arithmetic, in the same order. Shared by the
+// multi-channel engines (TalkBoxBank, MultiCarrierTalkBox, ChoirTalkBox).
+
+
+// r[j * Lanes + l] = sum_i x[i][l] * x[i + j][l], j = 0..maxLag.
+// Each sum runs in order of i like the mda loop; four lags are accumulated
+// together to keep the vector unit busy.
+template <int32_t Lanes>
+void autocorr_lanes(const float* x, int32_t n, int32_t maxLag, float* r)
+{
+    using Vec = typename SimdLaneVec<Lanes>::type;
+    using Op  = typename SimdLaneVec<Lanes>::ops;
+    constexpr int32_t W = Op::width;
+
+    for (int32_t g = 0; g < Lanes; g += W)
+    {
+        const float* xg = x + g;
+        int32_t j = 0;
+        for (; j + 3 <= maxLag; j += 4)
+        {
+            Vec a0 = Op::set1(0.0f), a1 = a0, a2 = a0, a3 = a0;
+            int32_t i = 0;
+            for (; i < n - j - 3; i++)
+            {
+                Vec xi = Op::load(xg + i * Lanes);
+                a0 = Op::add(a0, Op::mul(xi, Op::load(xg + (i + j) * Lanes)));
+                a1 = Op::add(a1, Op::mul(xi, Op::load(xg + (i + j + 1) * Lanes)));
+                a2 = Op::add(a2, Op::mul(xi, Op::load(xg + (i + j + 2) * Lanes)));
+                a3 = Op::add(a3, Op::mul(xi, Op::load(xg + (i + j + 3) * Lanes)));
+            }
+            // the shorter lags have up to three terms left
+            for (int32_t t = i; t < n - j; t++)     a0 = Op::add(a0, Op::mul(Op::load(xg + t * Lanes), Op::load(xg + (t + j) * Lanes)));
+            for (int32_t t = i; t < n - j - 1; t++) a1 = Op::add(a1, Op::mul(Op::load(xg + t * Lanes), Op::load(xg + (t + j + 1) * Lanes)));
+            for (int32_t t = i; t < n - j - 2; t++) a2 = Op::add(a2, Op::mul(Op::load(xg + t * Lanes), Op::load(xg + (t + j + 2) * Lanes)));
+            Op::store(r + j * Lanes + g, a0);
+            Op::store(r + (j + 1) * Lanes + g, a1);
+            Op::store(r + (j + 2) * Lanes + g, a2);
+            Op::store(r + (j + 3) * Lanes + g, a3);
+        }
+        for (; j <= maxLag; j++)
+        {
+            Vec a = Op::set1(0.0f);
+            for (int32_t i = 0; i < n - j; i++)
+                a = Op::add(a, Op::mul(Op::load(xg + i * Lanes), Op::load(xg + (i + j) * Lanes)));
+            Op::store(r + j * Lanes + g, a);
+        }
+    }
+}
+
+
+// Analysis half of mda lpc_gender() for one frame per lane: gender
+// resampling of 'buf' into 'scratch', autocorrelation into 'r', stability
+// fix, silence check, Durbin and coefficient clamp.
+//   order[l], gender[l]   per-lane LPC order and gender parameter
+//   maxOrder              highest order[l]
+// Writes k[j * Lanes + l] for j = 0..maxOrder (0 above the lane's order and
+// for a silent lane), G[l] (0 for a silent lane) and silent[l].
+// Returns true if at least one lane is voiced.
+template <int32_t Lanes>
+bool lpc_analyze_lanes(const float* buf, int32_t n, const int32_t* order, int32_t maxOrder, const float* gender,
+                       float* scratch, float* r, float* k, float* G, bool* silent)
+{
+    bool anyVoiced = false;
+
+    // Gender: resample each lane's frame (mda lpc_gender)
+    for (int32_t l = 0; l < Lanes; l++)
+    {
+        if (!lpc_gender_resample(buf + l, n, gender[l], scratch + l, Lanes))
+            for (int32_t i = 0; i < n; i++) scratch[i * Lanes + l] = buf[i * Lanes + l];
+    }
+
+    autocorr_lanes<Lanes>(scratch, n, maxOrder, r);
+
+    // Per lane: silence check, Durbin, coefficient clamp
+    for (int32_t l = 0; l < Lanes; l++)
+    {
+        float rl[ORD_MAX], kl[ORD_MAX], gl;
+        const int32_t ol = order[l];
+        for (int32_t j = 0; j <= ol; j++) rl[j] = r[j * Lanes + l];
+        rl[0] *= 1.001f;     // stability fix (mda)
+
+        silent[l] = rl[0] < 0.00001f;
+        if (silent[l]) { for (int32_t j = 0; j <= maxOrder; j++) k[j * Lanes + l] = 0.0f; G[l] = 0.0f; continue; }
+        anyVoiced = true;
+
+        lpc_durbin(rl, ol, kl, &gl);
+        for (int32_t j = 1; j <= ol; j++)
+        {
+            if (kl[j] > 0.995f) kl[j] = 0.995f; else if (kl[j] < -0.995f) kl[j] = -0.995f;
+        }
+        for (int32_t j = 0; j <= maxOrder; j++) k[j * Lanes + l] = (j <= ol) ? kl[j] : 0.0f;
+        G[l] = gl;
+    }
+    return anyVoiced;
+}
+
+
+// mda lattice on every lane, each with its own coefficients k[] and gain
+// G[l]: buf[i] = lattice(G * car[i]), i = 0..n-1. With SharedCarrier the
+// input is one mono carrier car[i] for all lanes, otherwise car is
+// interleaved like buf. 'z' is scratch for ORD_MAX * Lanes floats.
+//
+// Each sample is a chain of dependent operations through the o stages, so
+// on its own it runs at the latency of the FPU. Samples go in pairs to keep
+// two chains in flight, the second one stage behind the first: it needs z[j]
+// as the first sample leaves it, which is exactly what the first sample has
+// just computed. Every operation is the same as in the one-sample loop.
+template <int32_t Lanes, bool SharedCarrier = false>
+void lattice_lanes(const float* k, const float* G, int32_t o, const float* car, float* buf, int32_t n, float* z)
+{
+    using Vec = typename SimdLaneVec<Lanes>::type;
+    using Op  = typename SimdLaneVec<Lanes>::ops;
+    constexpr int32_t W = Op::width;
+
+    for (int32_t j = 0; j <= o; j++)
+        for (int32_t l = 0; l < Lanes; l++) z[j * Lanes + l] = 0.0f;
+
+    for (int32_t g = 0; g < Lanes; g += W)
+    {
+        const Vec gain = Op::load(G + g);
+        const float* kg = k + g;
+        float* zg = z + g;
+        auto input = [&](int32_t i) {
+            if constexpr (SharedCarrier) return Op::set1(car[i]);
+            else                         return Op::load(car + i * Lanes + g);
+        };
+        int32_t i = 0;
+
+        for (; o > 0 && i + 1 < n; i += 2)
+        {
+            Vec xa = Op::mul(gain, input(i));
+            Vec xb = Op::mul(gain, input(i + 1));
+
+            // first sample, stage o
+            Vec ko = Op::load(kg + o * Lanes);
+            Vec zo = Op::load(zg + (o - 1) * Lanes);
+            xa = Op::sub(xa, Op::mul(ko, zo));
+            Op::store(zg + o * Lanes, Op::add(zo, Op::mul(ko, xa)));
+
+            // first sample at stage j, second at stage j + 1
+            for (int32_t j = o - 1; j > 0; j--)
+            {
+                Vec kj = Op::load(kg + j * Lanes);
+                Vec zj = Op::load(zg + (j - 1) * Lanes);
+                xa = Op::sub(xa, Op::mul(kj, zj));
+                Vec za = Op::add(zj, Op::mul(kj, xa));
+
+                Vec kb = Op::load(kg + (j + 1) * Lanes);
+                xb = Op::sub(xb, Op::mul(kb, za));
+                Op::store(zg + j * Lanes, za);
+                Op::store(zg + (j + 1) * Lanes, Op::add(za, Op::mul(kb, xb)));
+            }
+
+            // first sample done (its output is z[0]), second sample, stage 1
+            Vec k1 = Op::load(kg + Lanes);
+            xb = Op::sub(xb, Op::mul(k1, xa));
+            Op::store(zg + Lanes, Op::add(xa, Op::mul(k1, xb)));
+            Op::store(zg, xb);
+            Op::store(buf + i * Lanes + g, xa);
+            Op::store(buf + (i + 1) * Lanes + g, xb);
+        }
+
+        // odd sample left (or order 0)
+        for (; i < n; i++)
+        {
+            Vec x = Op::mul(gain, input(i));
+            for (int32_t j = o; j > 0; j--)
+            {
+                Vec kj = Op::load(kg + j * Lanes);
+                Vec zj = Op::load(zg + (j - 1) * Lanes);
+                x = Op::sub(x, Op::mul(kj, zj));
+                Op::store(zg + j * Lanes, Op::add(zj, Op::mul(kj, x)));
+            }
+            Op::store(zg, x);
+            Op::store(buf + i * Lanes + g, x);
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+
+// Reflection coefficients from the autocorrelation r[0..p].
+//
+// Both functions solve the same normal equations and use the mda
+// conventions: k[1..p] are the lattice coefficients (k[0] is set to 0),
+// *g = sqrt(prediction error) is the gain of the synthesis filter.
+// If the error falls below 1e-20 the recursion stops there.
+//
+// Adaptive order: with minError > 0 the recursion also stops after the
+// first order i whose relative prediction error e_i / r[0] is below
+// minError. Both return the order actually reached; k[] above it is zero,
+// so a lattice run at that order gives the same output as one at p.
+
+// Largest order p the recursions accept (sizes their stack arrays)
+static constexpr int32_t LPC_MAX_ORDER = 63;
+
+// Levinson-Durbin: the original mda routine. Each step needs the whole
+// predictor a[] of the previous one, a dot product over it and a division;
+// the error is updated as e *= 1 - k^2. T is the accumulator type: float
+// for the engines, double for TalkBoxCore's wider analysis (both are
+// instantiated in LpcRecursion.cpp).
+template <typename T>
+int32_t lpc_durbin(const T* r, int32_t p, T* k, T* g, T minError = T(0));
+
+// Schur (Le Roux-Gueguen) recursion: propagates the two generator rows
+// U/V of the Toeplitz matrix instead of a[], and reads each k directly
+// from them:
+//      k[i]  = -U[i] / V[i-1]
+//      U[j] += k[i] * V[j-1],   V[j] = V[j-1] + k[i] * U[j]      (j = i..p)
+// The updates of one step are independent of each other, so they
+// vectorize, and all intermediate values stay bounded by r[0], which is
+// what makes it the usual choice in fixed point (see TalkBoxFixed).
+// The final V is the prediction error itself, not a running product.
+int32_t lpc_schur(const float* r, int32_t p, float* k, float* g, float minError = 0.0f);
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include "TalkBoxTypes.h"
+#include "AllPoleSynthesis.h"
+#include "StateBuffer.h"
+
+
+// Carrier side of the talkbox: filters the (decimated, pre-filtered)
+// carrier with the LpcFrameCoeffs of each frame and overlap-adds the result.
+//
+// The carrier is captured into two 50%-overlapped frames on the same
+// schedule as LpcAnalyzer. When process() reports a complete frame, the
+// caller hands over that frame's coefficients with synthesize(): the
+// all-pole filter runs over the captured carrier, and its output is faded
+// out by the window over the next N samples while the other frame fades in.
+//
+// All memory is allocated in the constructor; init() and the processing
+// never allocate.
+class LpcSynthesizer {
+    public:
+        LpcSynthesizer();
+        ~LpcSynthesizer();
+
+        LpcSynthesizer(const LpcSynthesizer&) = delete;
+        LpcSynthesizer& operator=(const LpcSynthesizer&) = delete;
+
+        // Frame length and window for the sample rate (talkbox_frame_length());
+        // clears the frames, resets the write position and the fallback counter
+        void init(float sampleRate);
+
+        // Synthesis filter (default: Lattice)
+        void setSynthesisMethod(SynthesisMethod method) { synth_method_ = method; }
+
+        // Number of DirectForm frames that fell back to the lattice since init()
+        uint32_t synthesisFallbacks() const { return synth_fallbacks_; }
+
+        int32_t frameLength() const { return N_; }
+
+        // Samples left until the next carrier frame is complete
+        int32_t samplesToFrame() const;
+
+        // Capture n <= samplesToFrame() carrier samples and write n output
+        // samples (overlap-add of the synthesized frames). Returns true if
+        // they complete a frame: synthesize() must then be called before the
+        // next process().
+        bool process(const float* car, float* out, int32_t n);
+
+        // Filter the completed carrier frame with 'frame' (the LPC of the
+        // modulator frame completed on the same sample)
+        void synthesize(const LpcFrameCoeffs& frame);
+
+        // Copy the write position and the live part of the frames out / back
+        // in (TalkBoxProcessor snapshots), between a synthesize() and the
+        // next process(). Same frame length on both sides.
+        void saveState(StateWriter& w) const;
+        void restoreState(StateReader& r);
+
+    private:
+        // Output frames (synthesized carrier), captured carrier frames, window
+        float* buf0_;
+        float* buf1_;
+        float* car0_;
+        float* car1_;
+        float* window_;
+
+        // Direct-form synthesis: filter, and its output with ALLPOLE_PAD floats of history in front
+        AllPoleFilter allpole_;
+        float* synth_buf_;
+        SynthesisMethod synth_method_ = SynthesisMethod::Lattice;
+        uint32_t synth_fallbacks_ = 0;
+
+        int32_t N_ = 0;             // frame length
+        int32_t pos_ = 0;           // write index of buf0_/car0_, buf1_/car1_ are N_/2 ahead
+        float* pending_ = nullptr;  // output frame waiting for synthesize()
+        float* pending_car_ = nullptr;
+};
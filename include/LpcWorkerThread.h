@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "TalkBoxProcessor.h"
+
+
+// Desktop worker for TalkBoxProcessor::setPipelinedAnalysis(): a thread
+// that runs serviceAnalysis() from construction to destruction. When no
+// frame is queued it sleeps for 'idle', a fraction of a frame (a frame is
+// about 16 ms), so it neither spins a core nor needs the audio thread to
+// signal it. Not used by the firmware build, which has no threads.
+//
+// Enable pipelined analysis before creating the worker, and destroy the
+// worker before init() or setPipelinedAnalysis() run again.
+class LpcWorkerThread {
+    public:
+        explicit LpcWorkerThread(TalkBoxProcessor& engine,
+                                 std::chrono::microseconds idle = std::chrono::microseconds(200))
+            : engine_(engine), idle_(idle), thread_([this] { run(); }) {}
+
+        ~LpcWorkerThread() {
+            stop_.store(true, std::memory_order_relaxed);
+            thread_.join();
+        }
+
+        LpcWorkerThread(const LpcWorkerThread&) = delete;
+        LpcWorkerThread& operator=(const LpcWorkerThread&) = delete;
+
+    private:
+        void run() {
+            while (!stop_.load(std::memory_order_relaxed))
+                if (!engine_.serviceAnalysis()) std::this_thread::sleep_for(idle_);
+        }
+
+        TalkBoxProcessor& engine_;
+        std::chrono::microseconds idle_;
+        std::atomic<bool> stop_{false};
+        std::thread thread_;        // last: starts once the members above exist
+};
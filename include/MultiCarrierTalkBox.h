@@ -0,0 +1,273 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "TalkBoxProcessor.h"
+#include "LpcLanes.h"
+#include "AllPassCascade.h"
+#include "DenormalGuard.h"
+#include "Autocorrelation.h"
+#include "LpcRecursion.h"
+#include "Simd.h"
+
+
+// One modulator driving 'Carriers' carriers (e.g. a vocal through several
+// synth layers) with a single LPC analysis.
+//
+// In TalkBoxProcessor the OLA buffer buf0_/buf1_ holds the modulator frame
+// until the frame is full, and is then overwritten by the synthesized
+// carrier frame. Here the two roles are split: mbuf0_/mbuf1_ collect the
+// windowed modulator (once), sbuf0_/sbuf1_ hold one synthesized frame per
+// carrier. Per frame the pre-emphasis, windowing, gender resampling,
+// autocorrelation and Durbin run once, and the same k[]/G drive the lattice
+// of every carrier. The analysis cost does not depend on 'Carriers'; each
+// carrier adds its pre-filter, OLA, lattice and post-filter, all run side by
+// side in SIMD lanes like TalkBoxBank.
+//
+// The analysis uses the direct autocorrelation kernel and the Durbin
+// recursion, so the output of carrier c is bit-exact with a
+// TalkBoxProcessor set to AutocorrMethod::Direct and the same DenormalMode,
+// fed the same modulator and carrier c.
+template <int32_t Carriers>
+class MultiCarrierTalkBox {
+    public:
+        static constexpr int32_t carriers = Carriers;
+
+        // Lanes actually processed: with SIMD the carrier count is padded to
+        // a multiple of 4 with silent carriers, which is cheaper than running
+        // an odd count one lane at a time
+        static constexpr int32_t LANES = (Carriers > 1 && TALKBOX_SIMD_WIDTH > 1) ? (Carriers + 3) / 4 * 4 : Carriers;
+
+        MultiCarrierTalkBox() {
+            mbuf0_  = new float[BUF_MAX];
+            mbuf1_  = new float[BUF_MAX];
+            gbuf_   = new float[BUF_MAX];
+            window_ = new float[BUF_MAX];
+            sbuf0_  = new float[BUF_MAX * LANES];
+            sbuf1_  = new float[BUF_MAX * LANES];
+            car0_   = new float[BUF_MAX * LANES];
+            car1_   = new float[BUF_MAX * LANES];
+            memset(mbuf0_, 0, sizeof(float) * BUF_MAX);
+            memset(mbuf1_, 0, sizeof(float) * BUF_MAX);
+            memset(sbuf0_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(sbuf1_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(car0_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(car1_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(car_, 0, sizeof(car_));      // padding lanes stay silent
+        }
+
+        ~MultiCarrierTalkBox() {
+            delete[] mbuf0_; delete[] mbuf1_;
+            delete[] sbuf0_; delete[] sbuf1_;
+            delete[] car0_;  delete[] car1_;
+            delete[] gbuf_;
+            delete[] window_;
+        }
+
+        MultiCarrierTalkBox(const MultiCarrierTalkBox&) = delete;
+        MultiCarrierTalkBox& operator=(const MultiCarrierTalkBox&) = delete;
+
+        // Update parameters in runtime (shared by all carriers)
+        void updateParams(const TalkBoxParams& params) {
+            order_    = talkbox_order(fs_, params.quality);
+            wet_gain_ = 0.5f * params.wet * params.wet;
+            dry_gain_ = 2.0f * params.dry * params.dry;
+            gender_   = params.gender;
+        }
+
+        // Select the denormal handling (default: Flush), as TalkBoxProcessor
+        void setDenormalMode(DenormalMode mode) { denormal_mode_ = mode; }
+
+        // Initialize engine: must call before processing
+        void init(float sampleRate, const TalkBoxParams& params) {
+            fs_ = std::clamp(sampleRate, 8000.0f, 96000.0f);
+            N_  = talkbox_frame_length(fs_);
+
+            talkbox_hann_window(window_, N_);
+
+            updateParams(params);
+
+            p0_ = 0;
+            p1_ = N_ / 2;
+            K_  = 0;
+            emphasis_ = 0.0f;
+            frames_   = 0;
+            memset(fx_, 0, sizeof(fx_));
+            prefilter_.reset();
+            postfilter_.reset();
+
+            // Empty frames, so a re-initialized engine starts like a new one
+            memset(mbuf0_, 0, sizeof(float) * BUF_MAX);
+            memset(mbuf1_, 0, sizeof(float) * BUF_MAX);
+            memset(sbuf0_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(sbuf1_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(car0_, 0, sizeof(float) * BUF_MAX * LANES);
+            memset(car1_, 0, sizeof(float) * BUF_MAX * LANES);
+        }
+
+        // Number of LPC analyses run since init(), whatever the carrier count
+        uint32_t analysisFrames() const { return frames_; }
+
+        // Process a block of `frames` samples: one mono modulator, and
+        // carIn[c]/outL[c]/outR[c] the mono buffers of carrier c
+        void processBlock(const float* modIn,
+                            const float* const* carIn,
+                            float* const* outL,
+                            float* const* outR,
+                            int32_t frames  )
+        {
+            const bool flush = denormal_mode_ == DenormalMode::Flush && ScopedDenormalFlush::supported;
+            ScopedDenormalFlush guard(flush);
+
+            for (int32_t done = 0; done < frames; done += STAGE_BLOCK)
+                processChunk(modIn + done, carIn, outL, outR, done, std::min(STAGE_BLOCK, frames - done));
+
+            // Clamp mode, or the fallback for targets without the hardware modes
+            if (!flush)
+            {
+                prefilter_.flushDenormals(1.0e-10f);
+                postfilter_.flushDenormals(1.0e-10f);
+            }
+        }
+
+    private:
+        using Vec = typename SimdLaneVec<LANES>::type;
+        using Op  = typename SimdLaneVec<LANES>::ops;
+        static constexpr int32_t W = Op::width;
+
+        void processChunk(const float* modIn, const float* const* carIn,
+                          float* const* outL, float* const* outR, int32_t off, int32_t n)
+        {
+            // 1. Interleave the carriers and pre-filter them
+            for (int32_t i = 0; i < n; i++)
+                for (int32_t c = 0; c < Carriers; c++) car_[i * LANES + c] = carIn[c][off + i];
+            prefilter_.process(car_, car_, n);
+
+            // 2. Half-rate analysis/synthesis, output held over the skipped samples
+            for (int32_t i = 0; i < n; i++)
+            {
+                if (K_++)
+                {
+                    K_ = 0;
+                    olaStep(modIn[i], car_ + i * LANES);
+                }
+                memcpy(out_ + i * LANES, fx_, sizeof(fx_));
+            }
+
+            // 3. Post-filter, mix wet + dry, de-interleave
+            postfilter_.process(out_, out_, n);
+            const Vec wet = Op::set1(wet_gain_);
+            const Vec dry = Op::set1(dry_gain_);
+            for (int32_t i = 0; i < n; i++)
+            {
+                const Vec m = Op::set1(modIn[i]);
+                for (int32_t g = 0; g < LANES; g += W)
+                {
+                    Vec y = Op::add(Op::mul(wet, Op::load(out_ + i * LANES + g)), Op::mul(dry, m));
+                    Op::store(out_ + i * LANES + g, y);
+                }
+            }
+            for (int32_t c = 0; c < Carriers; c++)
+                for (int32_t i = 0; i < n; i++)
+                    outL[c][off + i] = outR[c][off + i] = out_[i * LANES + c];
+        }
+
+        // One decimated sample: the modulator goes into the analysis frames
+        // once, every carrier into its own OLA buffers
+        void olaStep(float m, const float* car)
+        {
+            const float w  = window_[p0_];
+            const float w2 = 1.0f - w;
+
+            float e = m - emphasis_;
+            emphasis_ = m;
+            mbuf0_[p0_] = e * w;
+            mbuf1_[p1_] = e * w2;
+
+            const Vec vw  = Op::set1(w);
+            const Vec vw2 = Op::set1(w2);
+            for (int32_t g = 0; g < LANES; g += W)
+            {
+                Vec c = Op::load(car + g);
+                Op::store(car0_ + p0_ * LANES + g, c);
+                Op::store(car1_ + p1_ * LANES + g, c);
+
+                Vec fx = Op::mul(Op::load(sbuf0_ + p0_ * LANES + g), vw);
+                fx = Op::add(fx, Op::mul(Op::load(sbuf1_ + p1_ * LANES + g), vw2));
+                Op::store(fx_ + g, fx);
+            }
+
+            if (++p0_ >= N_) { lpcFrame(mbuf0_, sbuf0_, car0_); p0_ = 0; }
+            if (++p1_ >= N_) { lpcFrame(mbuf1_, sbuf1_, car1_); p1_ = 0; }
+        }
+
+        // Analyse the modulator frame 'mbuf' once, then synthesize every
+        // carrier frame of 'car' into 'sbuf' with the same k[]/G
+        void lpcFrame(const float* mbuf, float* sbuf, const float* car)
+        {
+            const int32_t n = N_;
+            float r[ORD_MAX], k[ORD_MAX], G;
+            frames_++;
+
+            // Resample the modulator for formant shifting (as lpc_gender())
+            const float* x = mbuf;
+            if (lpc_gender_resample(mbuf, n, gender_, gbuf_)) x = gbuf_;
+
+            autocorr(x, n, order_, r);
+            r[0] *= 1.001f;     // stability fix
+            if (r[0] < 0.00001f) { memset(sbuf, 0, sizeof(float) * n * LANES); return; }
+
+            int32_t o = lpc_durbin(r, order_, k, &G);
+            for (int32_t j = 0; j <= o; j++)
+            {
+                if (k[j] > 0.995f) k[j] = 0.995f; else if (k[j] < -0.995f) k[j] = -0.995f;
+            }
+
+            // Same coefficients in every lane
+            for (int32_t j = 0; j <= o; j++)
+                for (int32_t c = 0; c < LANES; c++) k_[j * LANES + c] = k[j];
+            for (int32_t c = 0; c < LANES; c++) G_[c] = G;
+
+            lattice_lanes<LANES>(k_, G_, o, car, sbuf, n, z_);
+        }
+
+        // Modulator analysis frames, and the window
+        float* mbuf0_;
+        float* mbuf1_;
+        float* gbuf_;       // gender-resampled frame
+        float* window_;
+
+        // Per-carrier synthesized frames and carrier frames, [sample * LANES + carrier]
+        float* sbuf0_;
+        float* sbuf1_;
+        float* car0_;
+        float* car1_;
+
+        // Chunk buffers, [sample * LANES + carrier]
+        float car_[STAGE_BLOCK * LANES];
+        float out_[STAGE_BLOCK * LANES];
+
+        // Lattice coefficients broadcast to the lanes, and its state
+        float k_[ORD_MAX * LANES];
+        float z_[ORD_MAX * LANES];
+        float G_[LANES];
+        float fx_[LANES] = {0};
+
+        // Processing state
+        int32_t N_ = 0;
+        int32_t order_ = 0;
+        int32_t p0_ = 0;
+        int32_t p1_ = 0;
+        int32_t K_ = 0;
+        uint32_t frames_ = 0;
+        float fs_ = 48000.0f;
+        DenormalMode denormal_mode_ = DenormalMode::Flush;
+        float wet_gain_ = 0.5f;
+        float dry_gain_ = 0.0f;
+        float gender_ = 0.5f;
+        float emphasis_ = 0.0f;
+
+        AllPassCascade<LANES> prefilter_;
+        AllPassCascade<LANES> postfilter_;
+};
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "TalkBoxProcessor.h"
+
+
+// Offline renderer for long files: the input is cut into chunks that are
+// rendered concurrently, one TalkBoxProcessor per chunk, and written
+// straight into their place in the output.
+//
+// Each chunk starts 'warmup' frames early and throws that output away, so
+// its engine state (all-pass filters, OLA frames, emphasis, held sample)
+// has caught up with the serial render by the first sample it keeps. The
+// chunk boundaries, warm-up included, fall on multiples of the LPC frame
+// period (2 * frame length input samples), so every chunk sees the same
+// decimation phase and frame grid as a serial render. In Recursive mode
+// they also fall on multiples of the update period (2 * update interval),
+// so the Durbin runs land on the same samples; the alignment is then the
+// least common multiple of the two (12528 samples at 48 kHz). The first
+// chunk has nothing before it and is bit-exact; the others differ from a
+// serial render only by what is left of the different start after the
+// warm-up. The Block analysis forgets everything within two frames, so
+// with the default four the output is bit-exact in practice, and
+// test/parallel_render allows 1e-6 in both modes.
+//
+// The chunks are handed out to the threads one at a time, so a slow chunk
+// (dense voiced passages) does not hold the others back. Desktop only:
+// the firmware has no threads. Pipelined analysis must stay off, since
+// nothing services it here.
+class ParallelRenderer {
+    public:
+        // 'threads' workers, 0 = one per core
+        explicit ParallelRenderer(int32_t threads = 0) { setThreads(threads); }
+
+        void setThreads(int32_t threads) {
+            threads_ = threads > 0 ? threads
+                                   : std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), (int32_t)1);
+        }
+
+        // Frames rendered and discarded before each chunk (default 4)
+        void setWarmupFrames(int32_t frames) { warmup_ = std::max(frames, (int32_t)0); }
+
+        // Chunk length in seconds, rounded up to whole alignment periods (default 10).
+        // Shorter chunks balance better, longer ones waste less on warm-up.
+        void setChunkSeconds(float seconds) { chunk_seconds_ = std::max(seconds, 0.1f); }
+
+        // Block size of the processBlock() calls (default 48)
+        void setBlockSize(int32_t frames) { block_ = std::max(frames, (int32_t)1); }
+
+        // Called on every engine after init(), e.g. to pick the autocorrelation
+        // or synthesis method; must configure them all the same way
+        void setConfigure(std::function<void(TalkBoxProcessor&)> configure) { configure_ = std::move(configure); }
+
+        int32_t threads() const { return threads_; }
+
+        // Render 'frames' samples of mono modulator and carrier to outL/outR
+        void render(const float* mod, const float* car, float* outL, float* outR,
+                    uint64_t frames, float sampleRate, const TalkBoxParams& params)
+        {
+            // Chunk and warm-up starts fall on multiples of 'align'
+            const uint64_t period = 2 * static_cast<uint64_t>(talkbox_frame_length(std::clamp(sampleRate, 8000.0f, 96000.0f)));
+            uint64_t align = period;
+            {
+                TalkBoxProcessor probe;
+                probe.init(sampleRate, params);
+                if (configure_) configure_(probe);
+                if (probe.analysisMode() == AnalysisMode::Recursive)
+                    align = std::lcm(period, 2 * static_cast<uint64_t>(probe.updateInterval()));
+            }
+            const uint64_t warm   = (period * warmup_ + align - 1) / align * align;
+            const uint64_t target = static_cast<uint64_t>(chunk_seconds_ * sampleRate);
+            const uint64_t chunk  = std::max<uint64_t>((target + align - 1) / align, 1) * align;
+            const uint64_t count  = (frames + chunk - 1) / chunk;
+
+            std::vector<LpcOrderStats> stats(count);
+            std::atomic<uint64_t> next{0};
+
+            auto work = [&]() {
+                std::vector<float> scratch(2 * static_cast<size_t>(block_));
+                for (uint64_t c = next.fetch_add(1); c < count; c = next.fetch_add(1))
+                {
+                    const uint64_t begin = c * chunk;
+                    const uint64_t end   = std::min(begin + chunk, frames);
+                    const uint64_t start = begin > warm ? begin - warm : 0;
+
+                    TalkBoxProcessor engine;
+                    engine.init(sampleRate, params);
+                    if (configure_) configure_(engine);
+
+                    // Warm-up: render into the scratch buffers and drop it
+                    for (uint64_t pos = start; pos < begin; pos += block_)
+                    {
+                        int32_t cur = static_cast<int32_t>(std::min<uint64_t>(block_, begin - pos));
+                        engine.processBlock(mod + pos, car + pos, scratch.data(), scratch.data() + block_, cur);
+                    }
+                    engine.resetOrderStats();
+
+                    for (uint64_t pos = begin; pos < end; pos += block_)
+                    {
+                        int32_t cur = static_cast<int32_t>(std::min<uint64_t>(block_, end - pos));
+                        engine.processBlock(mod + pos, car + pos, outL + pos, outR + pos, cur);
+                    }
+                    stats[c] = engine.orderStats();
+                }
+            };
+
+            const int32_t n = static_cast<int32_t>(std::min<uint64_t>(threads_, count));
+            std::vector<std::thread> pool;
+            for (int32_t t = 1; t < n; t++) pool.emplace_back(work);
+            work();                         // the calling thread renders too
+            for (std::thread& t : pool) t.join();
+
+            // Order statistics of the kept part of every chunk
+            stats_ = LpcOrderStats();
+            for (const LpcOrderStats& s : stats)
+            {
+                stats_.frames   += s.frames;
+                stats_.silent   += s.silent;
+                stats_.orderSum += s.orderSum;
+                stats_.minOrder  = std::min(stats_.minOrder, s.minOrder);
+                stats_.maxOrder  = std::max(stats_.maxOrder, s.maxOrder);
+                for (int32_t o = 0; o < ORD_MAX; o++) stats_.histogram[o] += s.histogram[o];
+            }
+        }
+
+        // Order used per frame over the last render(), as if rendered serially
+        const LpcOrderStats& orderStats() const { return stats_; }
+
+    private:
+        int32_t threads_ = 1;
+        int32_t warmup_ = 4;
+        int32_t block_ = 48;
+        float chunk_seconds_ = 10.0f;
+        std::function<void(TalkBoxProcessor&)> configure_;
+        LpcOrderStats stats_;
+};
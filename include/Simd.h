@@ -0,0 +1,157 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+
+// Compile-time SIMD detection shared by the DSP kernels.
+// Exactly one of the TALKBOX_SIMD_* macros is defined to 1 when the
+// target supports vector floats; otherwise the kernels fall back to
+// their scalar versions (e.g. Cortex-M7 on the Daisy, which has no NEON).
+//
+// On x86-64 SSE2 is always available; AVX is only used if the compiler
+// was told so (-mavx / -march=native / /arch:AVX).
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define TALKBOX_SIMD_AVX 1
+    #define TALKBOX_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TALKBOX_SIMD_SSE 1
+    #define TALKBOX_SIMD_WIDTH 4
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define TALKBOX_SIMD_NEON 1
+    #define TALKBOX_SIMD_WIDTH 4
+#else
+    #define TALKBOX_SIMD_WIDTH 1
+#endif
+
+// Fused multiply-add is only used when the target has it natively,
+// otherwise we keep separate multiply and add.
+#if defined(TALKBOX_SIMD_AVX) && defined(__FMA__)
+    #define TALKBOX_SIMD_FMA 1
+#endif
+
+
+// Horizontal sum helpers for the vector accumulators
+#if defined(TALKBOX_SIMD_AVX)
+static inline float simd_hsum(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+}
+#elif defined(TALKBOX_SIMD_SSE)
+static inline float simd_hsum(__m128 s)
+{
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+}
+#elif defined(TALKBOX_SIMD_NEON)
+static inline float simd_hsum(float32x4_t v)
+{
+    float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+#endif
+
+
+// Lane-wise vector operations, so one kernel source can be instantiated for
+// float (one lane) and for the vector types. Only plain add/sub/mul are
+// offered: each lane then performs exactly the scalar arithmetic.
+// (GCC warns that the alignment attribute of the vector types is dropped
+// in the template argument; harmless here, the ops never rely on it.)
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+template <typename V> struct SimdOps;
+
+template <> struct SimdOps<float> {
+    static constexpr int32_t width = 1;
+    static inline float load(const float* p)       { return *p; }
+    static inline void  store(float* p, float v)   { *p = v; }
+    static inline float set1(float x)              { return x; }
+    static inline float add(float a, float b)      { return a + b; }
+    static inline float sub(float a, float b)      { return a - b; }
+    static inline float mul(float a, float b)      { return a * b; }
+    // zero where |x| < t
+    static inline float flush(float x, float t)    { return (std::abs(x) < t) ? 0.0f : x; }
+};
+
+#if defined(TALKBOX_SIMD_AVX)
+template <> struct SimdOps<__m256> {
+    static constexpr int32_t width = 8;
+    static inline __m256 load(const float* p)      { return _mm256_loadu_ps(p); }
+    static inline void   store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+    static inline __m256 set1(float x)             { return _mm256_set1_ps(x); }
+    static inline __m256 add(__m256 a, __m256 b)   { return _mm256_add_ps(a, b); }
+    static inline __m256 sub(__m256 a, __m256 b)   { return _mm256_sub_ps(a, b); }
+    static inline __m256 mul(__m256 a, __m256 b)   { return _mm256_mul_ps(a, b); }
+    static inline __m256 flush(__m256 x, float t) {
+        __m256 a = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+        return _mm256_andnot_ps(_mm256_cmp_ps(a, _mm256_set1_ps(t), _CMP_LT_OQ), x);
+    }
+};
+#endif
+
+#if defined(TALKBOX_SIMD_AVX) || defined(TALKBOX_SIMD_SSE)
+template <> struct SimdOps<__m128> {
+    static constexpr int32_t width = 4;
+    static inline __m128 load(const float* p)      { return _mm_loadu_ps(p); }
+    static inline void   store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+    static inline __m128 set1(float x)             { return _mm_set1_ps(x); }
+    static inline __m128 add(__m128 a, __m128 b)   { return _mm_add_ps(a, b); }
+    static inline __m128 sub(__m128 a, __m128 b)   { return _mm_sub_ps(a, b); }
+    static inline __m128 mul(__m128 a, __m128 b)   { return _mm_mul_ps(a, b); }
+    static inline __m128 flush(__m128 x, float t) {
+        __m128 a = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+        return _mm_andnot_ps(_mm_cmplt_ps(a, _mm_set1_ps(t)), x);
+    }
+};
+#elif defined(TALKBOX_SIMD_NEON)
+template <> struct SimdOps<float32x4_t> {
+    static constexpr int32_t width = 4;
+    static inline float32x4_t load(const float* p)           { return vld1q_f32(p); }
+    static inline void        store(float* p, float32x4_t v) { vst1q_f32(p, v); }
+    static inline float32x4_t set1(float x)                  { return vdupq_n_f32(x); }
+    static inline float32x4_t add(float32x4_t a, float32x4_t b) { return vaddq_f32(a, b); }
+    static inline float32x4_t sub(float32x4_t a, float32x4_t b) { return vsubq_f32(a, b); }
+    static inline float32x4_t mul(float32x4_t a, float32x4_t b) { return vmulq_f32(a, b); }
+    static inline float32x4_t flush(float32x4_t x, float t) {
+        uint32x4_t m = vcltq_f32(vabsq_f32(x), vdupq_n_f32(t));
+        return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(x), m));
+    }
+};
+#endif
+
+
+// Widest vector type whose width divides 'Lanes', float if none does, and
+// its SimdOps. Used by the engines that keep 'Lanes' independent channels
+// side by side.
+template <typename V>
+struct SimdLaneVecOf { using type = V; using ops = SimdOps<V>; };
+
+template <int32_t Lanes, typename Enable = void>
+struct SimdLaneVec : SimdLaneVecOf<float> {};
+
+#if defined(TALKBOX_SIMD_AVX)
+template <int32_t Lanes>
+struct SimdLaneVec<Lanes, std::enable_if_t<Lanes % 8 == 0>> : SimdLaneVecOf<__m256> {};
+template <int32_t Lanes>
+struct SimdLaneVec<Lanes, std::enable_if_t<Lanes % 8 != 0 && Lanes % 4 == 0>> : SimdLaneVecOf<__m128> {};
+#elif defined(TALKBOX_SIMD_SSE)
+template <int32_t Lanes>
+struct SimdLaneVec<Lanes, std::enable_if_t<Lanes % 4 == 0>> : SimdLaneVecOf<__m128> {};
+#elif defined(TALKBOX_SIMD_NEON)
+template <int32_t Lanes>
+struct SimdLaneVec<Lanes, std::enable_if_t<Lanes % 4 == 0>> : SimdLaneVecOf<float32x4_t> {};
+#endif
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+
+
+// Wait-free single-producer single-consumer ring buffer of 'Capacity'
+// elements (a power of two). One thread may call the producer side
+// (writeSlot/publish, push), one other thread the consumer side
+// (front/release, pop); no call ever blocks or allocates.
+//
+// The slot API lets large elements be filled and read in place: the
+// producer writes into writeSlot() and makes it visible with publish(), the
+// consumer reads front() and gives the slot back with release(). A slot is
+// never handed to the producer again before it has been released.
+template <typename T, uint32_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        // Producer: free slot to fill, or nullptr if the queue is full
+        T* writeSlot() {
+            uint32_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) == Capacity) return nullptr;
+            return &items_[head & (Capacity - 1)];
+        }
+
+        // Producer: make the slot returned by writeSlot() visible
+        void publish() {
+            head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Producer: copy 'item' in; false if the queue is full
+        bool push(const T& item) {
+            T* slot = writeSlot();
+            if (!slot) return false;
+            *slot = item;
+            publish();
+            return true;
+        }
+
+        // Consumer: oldest element, or nullptr if the queue is empty
+        const T* front() const {
+            uint32_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) return nullptr;
+            return &items_[tail & (Capacity - 1)];
+        }
+
+        // Consumer: drop the element returned by front()
+        void release() {
+            tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Consumer: copy the oldest element out; false if the queue is empty
+        bool pop(T& item) {
+            const T* slot = front();
+            if (!slot) return false;
+            item = *slot;
+            release();
+            return true;
+        }
+
+        // Empty the queue; only while neither side is in use
+        void clear() {
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        // Producer and consumer indices on their own cache lines
+        alignas(64) std::atomic<uint32_t> head_{0};     // next slot to publish
+        alignas(64) std::atomic<uint32_t> tail_{0};     // next slot to release
+        alignas(64) T items_[Capacity];
+};
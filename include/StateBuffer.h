@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+
+// Sequential copy of engine state into and out of a caller-provided byte
+// buffer, for the snapshot/restore of TalkBoxProcessor. Values are copied
+// with memcpy in the order they are written, so the buffer needs no
+// alignment. Neither side ever allocates.
+//
+// A StateWriter with a null buffer only counts the bytes, which gives the
+// snapshot size without a second description of the layout. Running past
+// the end of the buffer stops the copy and clears ok().
+class StateWriter {
+    public:
+        StateWriter(void* dst, size_t capacity)
+            : dst_(static_cast<uint8_t*>(dst)), capacity_(capacity) {}
+
+        template <typename T>
+        void put(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "state must be plain data");
+            bytes(&value, sizeof(T));
+        }
+
+        void put(const float* values, int32_t n) { bytes(values, n * sizeof(float)); }
+
+        // Bytes written so far (or that would have been, when counting)
+        size_t size() const { return size_; }
+        bool ok() const { return ok_; }
+
+    private:
+        void bytes(const void* src, size_t n) {
+            if (dst_)
+            {
+                if (size_ + n > capacity_) { ok_ = false; return; }
+                if (n) memcpy(dst_ + size_, src, n);
+            }
+            size_ += n;
+        }
+
+        uint8_t* dst_;
+        size_t capacity_;
+        size_t size_ = 0;
+        bool ok_ = true;
+};
+
+class StateReader {
+    public:
+        StateReader(const void* src, size_t size)
+            : src_(static_cast<const uint8_t*>(src)), size_(size) {}
+
+        template <typename T>
+        void get(T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "state must be plain data");
+            bytes(&value, sizeof(T));
+        }
+
+        void get(float* values, int32_t n) { bytes(values, n * sizeof(float)); }
+
+        size_t position() const { return pos_; }
+        bool ok() const { return ok_; }
+
+    private:
+        void bytes(void* dst, size_t n) {
+            if (pos_ + n > size_) { ok_ = false; return; }
+            if (n) memcpy(dst, src_ + pos_, n);
+            pos_ += n;
+        }
+
+        const uint8_t* src_;
+        size_t size_;
+        size_t pos_ = 0;
+        bool ok_ = true;
+};
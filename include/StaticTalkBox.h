@@ -0,0 +1,280 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include "TalkBoxProcessor.h"
+#include "LpcRecursion.h"
+#include "AllPassCascade.h"
+
+
+// Compile-time specialized talkbox engine.
+//
+// TalkBoxProcessor derives the frame length, the order and the half-rate
+// toggle at runtime, so every loop has a runtime bound. When the sample rate
+// and the audio block size are fixed (the Daisy firmware runs 48 kHz with
+// 48-sample blocks) they can be constants instead:
+//
+//   - the OLA buffers are member arrays of exactly frameLength floats
+//   - the Hann window is a constexpr table built by the compiler
+//   - the half-rate toggle disappears: blocks are an even number of samples,
+//     so every block starts on a "skip" sample and the loop runs in pairs
+//   - the lattice is instantiated per order: its stages are unrolled, their
+//     coefficients and state stay in registers (the pre/post all-pass
+//     filters, the gender resample and Durbin are the shared kernels)
+//   - the Recursive / DirectForm / FFT options are not compiled in
+//
+// 'quality' cannot change a template argument, so the engine is instantiated
+// for a short list of orders and updateParams() dispatches to the one closest
+// to talkbox_order(sampleRate, quality). For those orders the output matches
+// TalkBoxProcessor (Block analysis, Direct autocorrelation, Lattice synthesis)
+// except for the window: the compile-time table is correctly rounded, while
+// the runtime std::cos() may be an ulp off for a few points (6 of 783 with
+// glibc), which moves the output by about 1e-6 (test/static_test).
+//
+// Usage:
+//      using Config = TalkBoxConfig<48000, 48>;
+//      StaticTalkBox<Config, 8, 12, 16, 20, 23> talkbox;
+//      talkbox.init(params);
+//      talkbox.processBlock(mod, car, outL, outR);     // Config::blockSize samples
+
+
+template <int32_t SampleRate, int32_t BlockSize>
+struct TalkBoxConfig {
+    static constexpr float   sampleRate  = static_cast<float>(SampleRate);
+    static constexpr int32_t blockSize   = BlockSize;
+    static constexpr int32_t frameLength = talkbox_frame_length(sampleRate);
+    static constexpr int32_t maxOrder    = talkbox_order(sampleRate, 1.0f);     // quality = 1
+
+    static_assert(SampleRate >= 8000 && SampleRate <= 96000, "sample rate outside the range init() accepts");
+    static_assert(BlockSize > 0 && BlockSize % 2 == 0, "the half-rate loop needs an even block size");
+};
+
+
+// Cosine for constant expressions (std::cos is not constexpr). The argument
+// is the float phase of the window loop, in [0, 2*pi]; after folding it into
+// [-pi, pi] the Taylor series converges to double precision, so rounding
+// to float gives the correctly rounded cosine (which std::cos(float) does
+// not always return, see above).
+constexpr double constexpr_cos(double x) {
+    constexpr double PI = 3.14159265358979323846;
+    while (x >  PI) x -= 2.0 * PI;
+    while (x < -PI) x += 2.0 * PI;
+
+    double x2 = x * x, term = 1.0, sum = 1.0;
+    for (int32_t i = 1; i < 30; i++) {
+        term *= -x2 / static_cast<double>((2 * i - 1) * (2 * i));
+        sum  += term;
+    }
+    return sum;
+}
+
+// Hann window of N points, built like talkbox_hann_window<float>():
+// the phase is accumulated in float, one increment per point.
+template <int32_t N>
+struct HannTable {
+    float w[N];
+
+    constexpr HannTable() : w{} {
+        float dp    = TWO_PI / static_cast<float>(N);
+        float phase = 0.0f;
+        for (int32_t i = 0; i < N; ++i) {
+            w[i]   = 0.5f - 0.5f * static_cast<float>(constexpr_cos(phase));
+            phase += dp;
+        }
+    }
+
+    constexpr float operator[](int32_t i) const { return w[i]; }
+};
+
+
+template <typename Config, int32_t... Orders>
+class StaticTalkBox {
+    public:
+        static constexpr int32_t N = Config::frameLength;
+        static constexpr int32_t blockSize = Config::blockSize;
+
+        static_assert(sizeof...(Orders) > 0, "instantiate at least one LPC order");
+        static_assert(((Orders > 0 && Orders <= Config::maxOrder) && ...),
+                      "orders must lie in 1..Config::maxOrder");
+
+        // Initialize engine: must call before processing
+        void init(const TalkBoxParams& params) {
+            memset(buf0_, 0, sizeof(buf0_));
+            memset(buf1_, 0, sizeof(buf1_));
+            memset(car0_, 0, sizeof(car0_));
+            memset(car1_, 0, sizeof(car1_));
+
+            updateParams(params);
+
+            pos_      = 0;
+            emphasis_ = 0.0f;
+            FX_       = 0.0f;
+            prefilter_.reset();
+            postfilter_.reset();
+        }
+
+        // Update parameters in runtime. The order requested by 'quality' is
+        // rounded to the nearest instantiated one.
+        void updateParams(const TalkBoxParams& params) {
+            int32_t want = talkbox_order(Config::sampleRate, params.quality);
+            int32_t best = 0, bestDist = ORD_MAX;
+            for (int32_t o : { Orders... }) {
+                int32_t dist = (o > want) ? o - want : want - o;
+                if (dist < bestDist) { best = o; bestDist = dist; }
+            }
+            order_ = best;
+            (selectFrame<Orders>(best), ...);
+
+            wet_gain_ = 0.5f * params.wet * params.wet;
+            dry_gain_ = 2.0f * params.dry * params.dry;
+            gender_   = params.gender;
+        }
+
+        // LPC order currently in use
+        int32_t order() const { return order_; }
+
+        // Process exactly Config::blockSize samples; modulator and carrier are mono
+        void processBlock(const float* modIn,
+                            const float* carIn,
+                            float* outL,
+                            float* outR  )
+        {
+            ScopedDenormalFlush guard;      // FTZ/DAZ for the block, as TalkBoxProcessor
+
+            int32_t p0   = pos_;
+            int32_t p1   = (pos_ + N/2) % N;      // 50% offset pointer
+            float   emph = emphasis_;
+            float   fx   = FX_;
+
+            // Carrier pre-filter over the whole block; the LPC output is
+            // collected in wet_ and post-filtered the same way below
+            prefilter_.process(carIn, car_, blockSize);
+
+            // Even samples keep the previous LPC output, odd samples run the
+            // decimated analysis (the K_ toggle of TalkBoxProcessor)
+            for (int32_t n = 0; n < blockSize; n += 2)
+            {
+                wet_[n] = fx;
+
+                float m = modIn[n + 1];
+                float c = car_[n + 1];
+
+                car0_[p0] = car1_[p1] = c;
+                c = m - emph;
+                emph = m;
+
+                float w = window_[p0];
+                fx = buf0_[p0] * w;
+                buf0_[p0] = c * w;
+                if (++p0 >= N)
+                {
+                    (this->*frame_)(buf0_, car0_);
+                    p0 = 0;
+                }
+
+                float w2 = 1.0f - w;
+                fx += buf1_[p1] * w2;
+                buf1_[p1] = c * w2;
+                if (++p1 >= N)
+                {
+                    (this->*frame_)(buf1_, car1_);
+                    p1 = 0;
+                }
+
+                wet_[n + 1] = fx;
+            }
+
+            pos_      = p0;
+            emphasis_ = emph;
+            FX_       = fx;
+
+            postfilter_.process(wet_, wet_, blockSize);
+            for (int32_t n = 0; n < blockSize; n++)
+            {
+                float out = wet_gain_ * wet_[n] + dry_gain_ * modIn[n];
+                outL[n] = out;
+                outR[n] = out;
+            }
+
+            // Software fallback for targets without the hardware modes
+            if constexpr (!ScopedDenormalFlush::supported)
+            {
+                prefilter_.flushDenormals(1.0e-10f);
+                postfilter_.flushDenormals(1.0e-10f);
+            }
+        }
+
+    private:
+        using FrameFn = void (StaticTalkBox::*)(float*, const float*);
+
+        template <int32_t Order>
+        void selectFrame(int32_t order) {
+            if (Order == order) frame_ = &StaticTalkBox::template lpcFrame<Order>;
+        }
+
+        // One LPC frame at a fixed order: lpc_gender() of TalkBoxProcessor
+        template <int32_t Order>
+        void lpcFrame(float* buf, const float* car) {
+            float r[Order + 1], k[Order + 1], G;
+
+            // Resample the modulator for formant shifting
+            const float* x = lpc_gender_resample(buf, N, gender_, gender_buf_) ? gender_buf_ : buf;
+
+            // The tiled SIMD kernel beats a constant-bound loop here: without
+            // -ffast-math the compiler may not reorder the float sums itself.
+            autocorr(x, N, Order, r);
+            r[0] *= 1.001f;     //stability fix
+
+            if (r[0] < 0.00001f) { memset(buf, 0, N * sizeof(float)); return; }
+
+            lpc_durbin(r, Order, k, &G);
+
+            for (int32_t i = 0; i <= Order; i++)
+            {
+                if (k[i] > 0.995f) k[i] = 0.995f; else if (k[i] < -0.995f) k[i] = -.995f;
+            }
+
+            float z[Order + 1] = {0};
+            for (int32_t i = 0; i < N; i++)
+            {
+                float x = lattice<Order>(G * car[i], k, z, std::make_integer_sequence<int32_t, Order>{});
+                buf[i] = z[0] = x;
+            }
+        }
+
+        // One sample through the lattice, stages Order..1 expanded by the fold
+        template <int32_t Order, int32_t... J>
+        static inline float lattice(float x, const float* k, float* z,
+                                    std::integer_sequence<int32_t, J...>) {
+            ((x -= k[Order - J] * z[Order - J - 1],
+              z[Order - J] = z[Order - J - 1] + k[Order - J] * x), ...);
+            return x;
+        }
+
+        static constexpr HannTable<N> window_{};
+
+        // Overlap-add buffers for voice and carrier
+        float buf0_[N];
+        float buf1_[N];
+        float car0_[N];
+        float car1_[N];
+        float gender_buf_[N];
+
+        // One block: pre-filtered carrier, LPC output before the post-filter
+        float car_[blockSize];
+        float wet_[blockSize];
+
+        // Processing state
+        FrameFn frame_ = nullptr;    // lpcFrame<> for the selected order
+        int32_t order_ = 0;
+        int32_t pos_ = 0;
+        float wet_gain_ = 0.5f;
+        float dry_gain_ = 0.0f;
+        float emphasis_ = 0.0f;
+        float gender_ = 0.5f;
+        float FX_ = 0.0f;
+
+        AllPassCascade<1> prefilter_;
+        AllPassCascade<1> postfilter_;
+};
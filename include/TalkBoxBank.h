@@ -0,0 +1,256 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "TalkBoxProcessor.h"
+#include "AllPassCascade.h"
+#include "DenormalGuard.h"
+#include "LpcLanes.h"
+#include "Simd.h"
+
+
+// Bank of 'Lanes' independent talkboxes processed in lockstep.
+//
+// Running one TalkBoxProcessor per vocal channel means one scalar pipeline
+// (and one set of heap buffers) per channel. Here the state is stored
+// structure-of-arrays: sample i of lane l lives at [i * Lanes + l], so one
+// vector instruction moves 4 (SSE/NEON) or 8 (AVX) channels through the
+// pre-filter, emphasis, window/OLA, autocorrelation, lattice and post-filter.
+//
+// All lanes share the sample rate, hence N_ and the frame boundaries: every
+// lane finishes a frame on the same sample. Everything else is per lane:
+//   - wet/dry/gender/quality. The lattice runs at the highest order in the
+//     bank; a lane with a lower order gets k = 0 on the extra stages, which
+//     pass the signal through unchanged.
+//   - the silence check and the Durbin recursion (scalar, once per frame)
+//
+// The arithmetic is the plain mda one (sequential autocorrelation sums,
+// Levinson-Durbin, lattice). With setDenormalMode(DenormalMode::Clamp)
+// every lane is bit-exact with a TalkBoxCore<float, float> fed the same
+// input, as long as the compiler does not contract the scalar code into
+// FMAs. Under the default Flush mode the lanes only differ from it where a
+// value would have gone denormal, i.e. by ~1e-10.
+//
+// Lanes should be a multiple of the SIMD width (4 or 8); other counts work
+// but run scalar.
+template <int32_t Lanes>
+class TalkBoxBank {
+    public:
+        static constexpr int32_t lanes = Lanes;
+
+        TalkBoxBank() {
+            buf0_ = new float[BUF_MAX * Lanes];
+            buf1_ = new float[BUF_MAX * Lanes];
+            car0_ = new float[BUF_MAX * Lanes];
+            car1_ = new float[BUF_MAX * Lanes];
+            gbuf_ = new float[BUF_MAX * Lanes];
+            window_ = new float[BUF_MAX];
+            memset(buf0_, 0, sizeof(float) * BUF_MAX * Lanes);
+            memset(buf1_, 0, sizeof(float) * BUF_MAX * Lanes);
+            memset(car0_, 0, sizeof(float) * BUF_MAX * Lanes);
+            memset(car1_, 0, sizeof(float) * BUF_MAX * Lanes);
+        }
+
+        ~TalkBoxBank() {
+            delete[] buf0_; delete[] car0_;
+            delete[] buf1_; delete[] car1_;
+            delete[] gbuf_;
+            delete[] window_;
+        }
+
+        TalkBoxBank(const TalkBoxBank&) = delete;
+        TalkBoxBank& operator=(const TalkBoxBank&) = delete;
+
+        // Update the parameters of one lane, or of all of them
+        void updateParams(int32_t lane, const TalkBoxParams& params) {
+            order_[lane]  = talkbox_order(fs_, params.quality);
+            wet_[lane]    = 0.5f * params.wet * params.wet;
+            dry_[lane]    = 2.0f * params.dry * params.dry;
+            gender_[lane] = params.gender;
+            max_order_    = *std::max_element(order_, order_ + Lanes);
+        }
+
+        void updateParams(const TalkBoxParams& params) {
+            for (int32_t l = 0; l < Lanes; l++) updateParams(l, params);
+        }
+
+        // Select the denormal handling (default: Flush), as TalkBoxProcessor
+        void setDenormalMode(DenormalMode mode) { denormal_mode_ = mode; }
+
+        // Initialize engine: must call before processing
+        void init(float sampleRate, const TalkBoxParams& params) {
+            fs_ = std::clamp(sampleRate, 8000.0f, 96000.0f);
+            N_  = talkbox_frame_length(fs_);
+
+            talkbox_hann_window(window_, N_);
+
+            updateParams(params);
+
+            p0_ = 0;
+            p1_ = N_ / 2;
+            K_  = 0;
+            memset(emph_, 0, sizeof(emph_));
+            memset(fx_, 0, sizeof(fx_));
+            prefilter_.reset();
+            postfilter_.reset();
+
+            // Empty frames, so a re-initialized bank starts like a new one
+            memset(buf0_, 0, sizeof(float) * BUF_MAX * Lanes);
+            memset(buf1_, 0, sizeof(float) * BUF_MAX * Lanes);
+            memset(car0_, 0, sizeof(float) * BUF_MAX * Lanes);
+            memset(car1_, 0, sizeof(float) * BUF_MAX * Lanes);
+        }
+
+        // Process a block of `frames` samples for every lane. modIn[l],
+        // carIn[l], outL[l] and outR[l] are the mono buffers of lane l.
+        void processBlock(const float* const* modIn,
+                            const float* const* carIn,
+                            float* const* outL,
+                            float* const* outR,
+                            int32_t frames  )
+        {
+            const bool flush = denormal_mode_ == DenormalMode::Flush && ScopedDenormalFlush::supported;
+            ScopedDenormalFlush guard(flush);
+
+            for (int32_t done = 0; done < frames; done += STAGE_BLOCK)
+                processChunk(modIn, carIn, outL, outR, done, std::min(STAGE_BLOCK, frames - done));
+
+            // Clamp mode, or the fallback for targets without the hardware modes
+            if (!flush)
+            {
+                prefilter_.flushDenormals(1.0e-10f);
+                postfilter_.flushDenormals(1.0e-10f);
+            }
+        }
+
+    private:
+        using Vec = typename SimdLaneVec<Lanes>::type;
+        using Op  = typename SimdLaneVec<Lanes>::ops;
+        static constexpr int32_t W = Op::width;
+
+        void processChunk(const float* const* modIn, const float* const* carIn,
+                          float* const* outL, float* const* outR, int32_t off, int32_t n)
+        {
+            // 1. Interleave the lanes, pre-filter every carrier
+            for (int32_t i = 0; i < n; i++)
+                for (int32_t l = 0; l < Lanes; l++)
+                {
+                    mod_[i * Lanes + l] = modIn[l][off + i];
+                    car_[i * Lanes + l] = carIn[l][off + i];
+                }
+            prefilter_.process(car_, car_, n);
+
+            // 2. Half-rate analysis/synthesis; the output is held over the
+            // skipped samples
+            for (int32_t i = 0; i < n; i++)
+            {
+                if (K_++)
+                {
+                    K_ = 0;
+                    olaStep(mod_ + i * Lanes, car_ + i * Lanes);
+                }
+                memcpy(out_ + i * Lanes, fx_, sizeof(fx_));
+            }
+
+            // 3. Post-filter, mix wet + dry, de-interleave
+            postfilter_.process(out_, out_, n);
+            for (int32_t i = 0; i < n; i++)
+                for (int32_t g = 0; g < Lanes; g += W)
+                {
+                    Vec y = Op::mul(Op::load(wet_ + g), Op::load(out_ + i * Lanes + g));
+                    y = Op::add(y, Op::mul(Op::load(dry_ + g), Op::load(mod_ + i * Lanes + g)));
+                    Op::store(out_ + i * Lanes + g, y);
+                }
+            for (int32_t l = 0; l < Lanes; l++)
+                for (int32_t i = 0; i < n; i++)
+                    outL[l][off + i] = outR[l][off + i] = out_[i * Lanes + l];
+        }
+
+        // One decimated sample for all lanes: emphasis, window, overlap-add,
+        // and the LPC of any frame that completes on this sample
+        void olaStep(const float* mod, const float* car)
+        {
+            float* b0 = buf0_ + p0_ * Lanes;
+            float* b1 = buf1_ + p1_ * Lanes;
+            const Vec w  = Op::set1(window_[p0_]);
+            const Vec w2 = Op::set1(1.0f - window_[p0_]);
+
+            for (int32_t g = 0; g < Lanes; g += W)
+            {
+                Vec c = Op::load(car + g);
+                Op::store(car0_ + p0_ * Lanes + g, c);
+                Op::store(car1_ + p1_ * Lanes + g, c);
+
+                Vec m = Op::load(mod + g);
+                Vec e = Op::sub(m, Op::load(emph_ + g));
+                Op::store(emph_ + g, m);
+
+                Vec fx = Op::mul(Op::load(b0 + g), w);
+                Op::store(b0 + g, Op::mul(e, w));
+                fx = Op::add(fx, Op::mul(Op::load(b1 + g), w2));
+                Op::store(b1 + g, Op::mul(e, w2));
+                Op::store(fx_ + g, fx);
+            }
+
+            if (++p0_ >= N_) { lpcFrame(buf0_, car0_); p0_ = 0; }
+            if (++p1_ >= N_) { lpcFrame(buf1_, car1_); p1_ = 0; }
+        }
+
+        // LPC analysis of a full frame for all lanes, then the lattice
+        // filters the frame's carrier in place of the analysed buffer
+        void lpcFrame(float* buf, const float* car)
+        {
+            const int32_t n = N_;
+            const int32_t o = max_order_;
+            bool silent[Lanes];
+
+            // Gender, autocorrelation, per-lane silence check and Durbin
+            bool anyVoiced = lpc_analyze_lanes<Lanes>(buf, n, order_, o, gender_, gbuf_, r_, k_, G_, silent);
+
+            // Lattice, all lanes at once (order o, see the class comment)
+            if (anyVoiced) lattice_lanes<Lanes>(k_, G_, o, car, buf, n, z_);
+            for (int32_t l = 0; l < Lanes; l++)
+                if (silent[l])
+                    for (int32_t i = 0; i < n; i++) buf[i * Lanes + l] = 0.0f;
+        }
+
+        // Overlap-add buffers for voice and carrier, [sample * Lanes + lane]
+        float* buf0_;
+        float* buf1_;
+        float* car0_;
+        float* car1_;
+        float* gbuf_;       // gender-resampled frame
+        float* window_;
+
+        // Chunk buffers, [sample * Lanes + lane]
+        float mod_[STAGE_BLOCK * Lanes];
+        float car_[STAGE_BLOCK * Lanes];
+        float out_[STAGE_BLOCK * Lanes];
+
+        // LPC of the current frame, [coefficient * Lanes + lane]
+        float r_[ORD_MAX * Lanes];
+        float k_[ORD_MAX * Lanes];
+        float z_[ORD_MAX * Lanes];
+        float G_[Lanes];
+
+        // Per-lane parameters and state
+        int32_t order_[Lanes] = {0};
+        int32_t max_order_ = 0;
+        float wet_[Lanes];
+        float dry_[Lanes];
+        float gender_[Lanes];
+        float emph_[Lanes] = {0};
+        float fx_[Lanes] = {0};
+
+        // Shared processing state
+        int32_t N_ = 0;
+        int32_t p0_ = 0;
+        int32_t p1_ = 0;
+        int32_t K_ = 0;
+        float fs_ = 48000.0f;
+        DenormalMode denormal_mode_ = DenormalMode::Flush;
+
+        AllPassCascade<Lanes> prefilter_;
+        AllPassCascade<Lanes> postfilter_;
+};
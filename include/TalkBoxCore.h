@@ -0,0 +1,243 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "TalkBoxProcessor.h"
+#include "LpcRecursion.h"
+
+
+// Generic-precision talkbox core, for reference and accuracy builds.
+//
+// The plain mda algorithm (scalar autocorrelation, Levinson-Durbin,
+// lattice) with two type parameters:
+//   - Sample: OLA buffers, window, filters and the lattice
+//   - Accum:  autocorrelation r[] and the Durbin recursion
+//
+//      TalkBoxCore<float, float>     the original mda arithmetic; bit-exact
+//                                    with the pre-SIMD TalkBoxProcessor
+//      TalkBoxCore<float, double>    float signal path, double analysis
+//      TalkBoxCore<double, double>   reference for the optimized kernels
+//                                    (see test/accuracy_test.cpp)
+//
+// TalkBoxProcessor stays the optimized float engine; this class has none of
+// its backends.
+template <typename Sample, typename Accum = Sample>
+class TalkBoxCore {
+    public:
+        TalkBoxCore() {
+            buf0_       = new Sample[BUF_MAX];
+            buf1_       = new Sample[BUF_MAX];
+            car0_       = new Sample[BUF_MAX];
+            car1_       = new Sample[BUF_MAX];
+            window_     = new Sample[BUF_MAX];
+            gender_buf_ = new Sample[BUF_MAX];
+            memset(buf0_, 0, sizeof(Sample) * BUF_MAX);
+            memset(buf1_, 0, sizeof(Sample) * BUF_MAX);
+            memset(car0_, 0, sizeof(Sample) * BUF_MAX);
+            memset(car1_, 0, sizeof(Sample) * BUF_MAX);
+        }
+
+        ~TalkBoxCore() {
+            delete[] buf0_; delete[] car0_;
+            delete[] buf1_; delete[] car1_;
+            delete[] window_;
+            delete[] gender_buf_;
+        }
+
+        TalkBoxCore(const TalkBoxCore&) = delete;
+        TalkBoxCore& operator=(const TalkBoxCore&) = delete;
+
+        // Update parameters in runtime
+        void updateParams(const TalkBoxParams& params) {
+            order_    = talkbox_order(fs_, params.quality);
+            wet_gain_ = Sample(0.5f * params.wet * params.wet);
+            dry_gain_ = Sample(2.0f * params.dry * params.dry);
+            gender_   = Sample(params.gender);
+        }
+
+        // Initialize engine: must call before processing
+        void init(float sampleRate, const TalkBoxParams& params) {
+            fs_ = std::clamp(sampleRate, 8000.0f, 96000.0f);
+            N_  = talkbox_frame_length(fs_);
+
+            talkbox_hann_window(window_, N_);       // in Sample precision
+
+            updateParams(params);
+
+            pos_      = 0;
+            K_        = 0;
+            emphasis_ = Sample(0);
+            FX_       = Sample(0);
+            unstable_ = 0;
+            d0_ = d1_ = d2_ = d3_ = d4_ = Sample(0);
+            u0_ = u1_ = u2_ = u3_ = u4_ = Sample(0);
+
+            // Empty frames, so a re-initialized engine starts like a new one
+            memset(buf0_, 0, sizeof(Sample) * BUF_MAX);
+            memset(buf1_, 0, sizeof(Sample) * BUF_MAX);
+            memset(car0_, 0, sizeof(Sample) * BUF_MAX);
+            memset(car1_, 0, sizeof(Sample) * BUF_MAX);
+        }
+
+        // Factor applied to r[0] before Durbin (white-noise correction).
+        // Default 1.001, the mda "stability fix"; 1 disables it.
+        void setStabilityFix(Accum factor) { stability_fix_ = factor; }
+
+        // Frames whose unclamped reflection coefficients reached |k| >= 1,
+        // i.e. where the recursion lost positive definiteness
+        uint32_t unstableFrames() const { return unstable_; }
+
+        // Process a block of `frames` samples; modulator and carrier are mono.
+        // IO is float for the normal interface, or double to read the
+        // reference output without rounding it.
+        template <typename IO>
+        void processBlock(const IO* modIn, const IO* carIn, IO* outL, IO* outR, int32_t frames) {
+            int32_t p0   = pos_;
+            int32_t p1   = (pos_ + N_/2) % N_;
+            Sample  emph = emphasis_;
+            Sample  fx   = FX_;
+
+            const Sample h0 = Sample(0.3f);
+            const Sample h1 = Sample(0.77f);
+
+            for (int32_t n = 0; n < frames; ++n)
+            {
+                Sample m = Sample(modIn[n]);
+                Sample c = Sample(carIn[n]);
+                Sample dry = m;
+
+                {
+                    Sample p = d0_ + h0 * c;
+                    d0_ = d1_;  d1_ = c - h0 * p;
+                    Sample q = d2_ + h1 * d4_;
+                    d2_ = d3_;  d3_ = d4_ - h1 * q;
+                    d4_ = c;
+                    c = p + q;
+                }
+
+                if (K_++)
+                {
+                    K_ = 0;
+
+                    car0_[p0] = car1_[p1] = c;
+                    c = m - emph;
+                    emph = m;
+
+                    Sample w = window_[p0];
+                    fx = buf0_[p0] * w;
+                    buf0_[p0] = c * w;
+                    if (++p0 >= N_) { lpc_gender(buf0_, car0_, N_, order_); p0 = 0; }
+
+                    Sample w2 = Sample(1) - w;
+                    fx += buf1_[p1] * w2;
+                    buf1_[p1] = c * w2;
+                    if (++p1 >= N_) { lpc_gender(buf1_, car1_, N_, order_); p1 = 0; }
+                }
+
+                {
+                    Sample p = u0_ + h0 * fx;
+                    u0_ = u1_;  u1_ = fx - h0 * p;
+                    Sample q = u2_ + h1 * u4_;
+                    u2_ = u3_;  u3_ = u4_ - h1 * q;
+                    u4_ = fx;
+                    c = p + q;
+                }
+
+                Sample out = wet_gain_ * c + dry_gain_ * dry;
+                outL[n] = IO(out);
+                outR[n] = IO(out);
+            }
+
+            pos_      = p0;
+            emphasis_ = emph;
+            FX_       = fx;
+
+            const Sample den = Sample(1.0e-10f);
+            if (std::abs(d0_) < den) d0_ = Sample(0);
+            if (std::abs(d1_) < den) d1_ = Sample(0);
+            if (std::abs(d2_) < den) d2_ = Sample(0);
+            if (std::abs(d3_) < den) d3_ = Sample(0);
+            if (std::abs(u0_) < den) u0_ = Sample(0);
+            if (std::abs(u1_) < den) u1_ = Sample(0);
+            if (std::abs(u2_) < den) u2_ = Sample(0);
+            if (std::abs(u3_) < den) u3_ = Sample(0);
+        }
+
+        // Kernels of the core, public so the accuracy test can drive them
+        // directly with reference data.
+
+        // Autocorrelation of x[0..n-1], one lag at a time, summed in Accum
+        static void autocorr(const Sample* x, int32_t n, int32_t maxLag, Accum* r) {
+            for (int32_t j = 0; j <= maxLag; j++)
+            {
+                Accum s = Accum(0);
+                for (int32_t i = 0; i < n - j; i++) s += Accum(x[i]) * Accum(x[i + j]);
+                r[j] = s;
+            }
+        }
+
+    private:
+        // The gender resample (in Sample) and Levinson-Durbin (in Accum)
+        // are the shared lpc_gender_resample() and lpc_durbin()
+        void lpc_gender(Sample* buf, const Sample* car, int32_t n, int32_t o) {
+            Accum r[ORD_MAX] = {}, k[ORD_MAX], G;
+            int32_t i;
+
+            const Sample* frame = lpc_gender_resample(buf, n, gender_, gender_buf_) ? gender_buf_ : buf;
+            autocorr(frame, n, o, r);
+            r[0] *= stability_fix_;
+
+            if (r[0] < Accum(0.00001f)) { for (i = 0; i < n; i++) buf[i] = Sample(0); return; }
+
+            lpc_durbin(r, o, k, &G);
+
+            bool unstable = false;
+            for (i = 1; i <= o; i++)
+            {
+                if (!(std::abs(k[i]) < Accum(1))) unstable = true;
+                if (k[i] > Accum(0.995f)) k[i] = Accum(0.995f); else if (k[i] < Accum(-0.995f)) k[i] = Accum(-0.995f);
+            }
+            if (unstable) unstable_++;
+
+            // Lattice in Sample precision
+            Sample ks[ORD_MAX], z[ORD_MAX], g = Sample(G), x;
+            for (i = 0; i <= o; i++) { ks[i] = Sample(k[i]); z[i] = Sample(0); }
+            for (i = 0; i < n; i++)
+            {
+                x = g * car[i];
+                for (int32_t j = o; j > 0; j--)
+                {
+                    x -= ks[j] * z[j - 1];
+                    z[j] = z[j - 1] + ks[j] * x;
+                }
+                buf[i] = z[0] = x;
+            }
+        }
+
+        // Overlap-add buffers for voice and carrier
+        Sample* buf0_;
+        Sample* buf1_;
+        Sample* car0_;
+        Sample* car1_;
+        Sample* window_;
+        Sample* gender_buf_;
+
+        // Processing state
+        int32_t N_ = 0;
+        int32_t order_ = 0;
+        int32_t pos_ = 0;
+        int32_t K_ = 0;
+        float   fs_ = 48000.0f;
+        Accum   stability_fix_ = Accum(1.001f);
+        uint32_t unstable_ = 0;
+        Sample wet_gain_ = Sample(0.5f);
+        Sample dry_gain_ = Sample(0);
+        Sample emphasis_ = Sample(0);
+        Sample gender_ = Sample(0.5f);
+        Sample FX_ = Sample(0);
+
+        // Pre-emphasis and de-emphasis filter states
+        Sample d0_ = 0, d1_ = 0, d2_ = 0, d3_ = 0, d4_ = 0;
+        Sample u0_ = 0, u1_ = 0, u2_ = 0, u3_ = 0, u4_ = 0;
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include "TalkBoxProcessor.h"
+
+
+// Fixed-point variant of TalkBoxProcessor.
+//
+// Same algorithm and the same interface, but every DSP step runs on
+// integers, so the FPU is only touched at the float interface and in init():
+//
+//   - carrier OLA buffers car0_/car1_ :  int16, Q1.14  (range +/-2)
+//   - voice/synth OLA buffers buf0_/buf1_, filter states, lattice state:
+//                                        int32, Q7.24  (range +/-128)
+//   - window, filter and reflection coefficients: Q30/Q31
+//   - autocorrelation: 64-bit accumulators on a block-normalized frame
+//   - reflection coefficients: Schur recursion in Q31 (no float divisions)
+//   - lattice: saturating, Q31 coefficients times Q7.24 state
+//
+// The float engine stays the reference; test/fixed_test.cpp compares both.
+class TalkBoxFixed {
+    public:
+        TalkBoxFixed();
+        ~TalkBoxFixed();
+
+        // Update parameters in runtime
+        void updateParams(const TalkBoxParams& params);
+
+        // Initialize engine: must call before processing
+        void init(float sampleRate, const TalkBoxParams& params);
+
+        // Process a block of `frames` samples; modulator and carrier are mono
+        void processBlock(const float* modIn,
+                            const float* carIn,
+                            float* outL,
+                            float* outR,
+                            int32_t frames  );
+
+        // Same, with Q31 input and output (e.g. straight from an integer codec)
+        void processBlock(const int32_t* modIn,
+                            const int32_t* carIn,
+                            int32_t* outL,
+                            int32_t* outR,
+                            int32_t frames  );
+
+    private:
+        template <typename Sample>
+        void process(const Sample* modIn, const Sample* carIn,
+                     Sample* outL, Sample* outR, int32_t frames);
+
+        void lpc_gender(int32_t* buf, const int16_t* car, int32_t n, int32_t o);
+        static void lpc_schur(const int32_t* r, int32_t p, int32_t* k, int64_t* err);
+
+        // Overlap-add buffers
+        int32_t* buf0_;
+        int32_t* buf1_;
+        int16_t* car0_;
+        int16_t* car1_;
+        int32_t* window_;       // Hann window, Q30
+        int32_t* frame_;        // resampled, block-normalized copy of the frame
+
+        // Processing state
+        int32_t N_ = 0;
+        int32_t order_ = 0;
+        int32_t pos_ = 0;
+        int32_t K_ = 0;
+        float   fs_ = 48000.0f;
+        int32_t wet_gain_ = 0;      // Q29
+        int32_t dry_gain_ = 0;      // Q29
+        int32_t ratio_ = 0;         // gender resampling step, Q16
+        int32_t emphasis_ = 0;      // Q7.24
+        int32_t FX_ = 0;            // Q7.24
+
+        // Pre-emphasis and de-emphasis filter states, Q7.24
+        int32_t d0_ = 0, d1_ = 0, d2_ = 0, d3_ = 0, d4_ = 0;
+        int32_t u0_ = 0, u1_ = 0, u2_ = 0, u3_ = 0, u4_ = 0;
+};
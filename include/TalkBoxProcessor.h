@@ -2,21 +2,19 @@
 #include <cstdint>
 #include <cmath>
 #include <cstring>
+#include "TalkBoxTypes.h"
+#include "Autocorrelation.h"
+#include "LpcAnalyzer.h"
+#include "LpcSynthesizer.h"
+#include "LpcAnalysisPipe.h"
+#include "AllPassCascade.h"
+#include "DenormalGuard.h"
+#include "StateBuffer.h"
 
 
-static constexpr int32_t BUF_MAX = 1600;
-static constexpr int32_t ORD_MAX = 50;
-static constexpr float TWO_PI = 6.28318530717958647692f;
-
-
-struct TalkBoxParams {
-    float wet     = 1.0f;       // [0..1]
-    float dry     = 0.0f;       // [0..1]
-    float quality = 1.0f;       // [0..1]
-    float gender  = 0.5f;       // [0=male, 0.5=norm, 1=female]
-};
-
-
+// Talkbox engine: carrier pre-filter, half-rate LPC vocoding, post-filter
+// and wet/dry mix. In Block mode the LPC is an LpcAnalyzer (modulator)
+// feeding an LpcSynthesizer (carrier) one LpcFrameCoeffs per frame.
 class TalkBoxProcessor {
     public:
         TalkBoxProcessor();        // Constructor
@@ -25,7 +23,85 @@ class TalkBoxProcessor {
         // Update parameters in runtime
         void updateParams(const TalkBoxParams& params);
 
-        // Initialize engine: must call before processing
+        // Select the autocorrelation backend (default: Direct). The tiled
+        // direct kernel is faster than the FFT at every frame length and
+        // order the engine uses (lpc_bench times both), even at 96 kHz with
+        // the highest order. Safe to call at any time, nothing is allocated.
+        void setAutocorrMethod(AutocorrMethod method);
+
+        // Select the analysis mode (default: Block). 'updateInterval' is the
+        // number of decimated samples between two Durbin runs in Recursive
+        // mode (the analysis runs at half the sample rate). Recursive mode
+        // trades the frame-boundary burst for a flat per-sample cost; it
+        // ignores the gender parameter, which needs a whole frame to resample.
+        void setAnalysisMode(AnalysisMode mode, int32_t updateInterval = 24);
+        AnalysisMode analysisMode() const { return analysis_mode_; }
+        int32_t updateInterval() const { return update_interval_; }
+
+        // Select the synthesis filter for Block analysis (default: Lattice)
+        void setSynthesisMethod(SynthesisMethod method);
+
+        // Select the recursion for the reflection coefficients (default: Durbin)
+        void setReflectionMethod(ReflectionMethod method);
+
+        // Select the denormal handling (default: Flush)
+        void setDenormalMode(DenormalMode mode);
+
+        // Pipelined analysis (Block mode, default: off). When on, each
+        // completed modulator frame is queued for a worker thread that calls
+        // serviceAnalysis(), and the synthesis uses its coefficients one
+        // frame later (analysisLatency()). The audio thread then only runs
+        // the lattice and bookkeeping; a frame the worker has not finished in
+        // time is analysed synchronously. Allocates on the first call:
+        // call outside the audio callback, with no worker running.
+        void setPipelinedAnalysis(bool enable);
+
+        // Worker thread entry: analyse one queued frame, false if none was waiting
+        bool serviceAnalysis() { return pipe_ && pipe_->service(); }
+
+        // Delay the pipelined analysis adds to the vocoded signal, in samples
+        int32_t analysisLatency() const { return pipelined_ ? N_ : 0; }
+
+        // Frames the worker missed, analysed on the audio thread instead
+        uint32_t pipelineMisses() const { return pipe_ ? pipe_->misses() : 0; }
+
+        // Adaptive LPC order: 0 disables (default). With minError > 0 the
+        // recursion stops at the first order whose relative prediction error
+        // e/r[0] is below minError (e.g. 0.01 = -20 dB) and the lattice runs
+        // at that order for the frame; the quality order is the upper limit.
+        void setAdaptiveOrder(float minError);
+
+        // Order actually used per frame since init() or resetOrderStats()
+        const LpcOrderStats& orderStats() const { return analyzer_.orderStats(); }
+        void resetOrderStats() { analyzer_.resetOrderStats(); }
+
+        // Number of DirectForm frames that fell back to the lattice since init()
+        uint32_t synthesisFallbacks() const { return synth_.synthesisFallbacks(); }
+
+        // Snapshot of the processing state: OLA frames, all-pass filters,
+        // emphasis, held sample, Recursive analysis and, when pipelined, the
+        // frame in flight. Not the parameters or settings (the caller keeps
+        // those and re-applies them) nor the statistics and counters.
+        // The snapshot is copied into a caller-provided buffer of
+        // snapshotSize() bytes, which depends only on the sample rate and on
+        // pipelined analysis (about 14 KB at 48 kHz, 17 KB pipelined).
+        size_t snapshotSize() const;
+
+        // Write a snapshot to 'dst'. Returns the bytes written, 0 if
+        // 'capacity' is too small.
+        size_t saveSnapshot(void* dst, size_t capacity) const;
+
+        // Continue from a snapshot of an engine initialized at the same
+        // sample rate: with the same settings and input, the output is
+        // bit-exact with what that engine produced after the snapshot.
+        // Returns false and changes nothing if 'src' is not such a snapshot.
+        // Only copies, never allocates: can run on the audio thread between
+        // two processBlock() calls.
+        bool restoreSnapshot(const void* src, size_t size);
+
+        // Initialize engine: must call before processing. Clears all the
+        // processing state, so an engine can be re-initialized to start a
+        // new render exactly like a new one (settings are kept).
         void init(float sampleRate, const TalkBoxParams& params);
 
         // Process a block of `frames` samples; modulator and carrier are mono
@@ -36,32 +112,56 @@ class TalkBoxProcessor {
                             int32_t frames  );  
 
     private:
-        // LPC helper functions (credits to mda plugins)
-        void lpc(float* buf, float* car, int32_t n, int32_t o);
-        void lpc_gender(float* buf, float* car, int32_t n, int32_t o, float gender_param);
-        void lpc_durbin(float* r, int32_t p, float* k, float* g);
-
-        // Overlap-add buffers for voice and carrier
-        float* buf0_;
-        float* buf1_;
-        float* car0_;
-        float* car1_;
-        float* window_;
-        float* gender_buf_;
+        static constexpr uint32_t SNAPSHOT_MAGIC = 0x31534254;     // "TBS1"
+        static constexpr uint32_t SNAPSHOT_PIPELINED = 1;          // flag: the pipe's frame follows
+
+        void writeState(StateWriter& w, uint32_t flags) const;
+        size_t snapshotBytes(uint32_t flags) const;
+
+        void updateRecursive();
+        void processChunk(const float* modIn, const float* carIn, float* outL, float* outR, int32_t n);
+        void olaStage(int32_t count);
+        void recursiveStage(int32_t count);
+        float latticeStep(float c);
+
+        // Block mode: the modulator side produces one coefficient record per
+        // frame, the carrier side consumes it (credits to mda plugins)
+        LpcAnalyzer analyzer_;
+        LpcSynthesizer synth_;
+        LpcFrameCoeffs frame_;
+        LpcAnalysisPipe* pipe_ = nullptr;       // pipelined analysis, allocated on request
+        bool pipelined_ = false;
+        DenormalMode denormal_mode_ = DenormalMode::Flush;
+
+        // Recursive analysis state: running autocorrelation plus a lattice
+        // that keeps its state across samples instead of restarting per frame
+        RecursiveAutocorrelator rec_;
+        AnalysisMode analysis_mode_ = AnalysisMode::Block;
+        int32_t update_interval_ = 24;
+        int32_t update_count_ = 0;
+        float rec_scale_ = 1.0f;        // matches r[] to the level of a Hann-windowed frame
+        float rk_[ORD_MAX];             // reflection coefficients in use
+        float rz_[ORD_MAX];             // lattice state
+        float rG_ = 0.0f;               // lattice input gain
+        int32_t rorder_ = 0;            // lattice order in use
+
+        // Stage buffers of processBlock(), one chunk of STAGE_BLOCK samples
+        float stage_car_[STAGE_BLOCK];          // pre-filtered carrier
+        float stage_out_[STAGE_BLOCK];          // LPC output held over the skipped samples, then post-filtered
+        float dec_car_[STAGE_BLOCK / 2];        // decimated carrier
+        float dec_mod_[STAGE_BLOCK / 2];        // decimated modulator
+        float dec_emph_[STAGE_BLOCK / 2];       // pre-emphasized decimated modulator
+        float dec_fx_[STAGE_BLOCK / 2];         // LPC output at the decimated rate
 
         // Processing state
         int32_t   N_ = 0;            // current window size
-        int32_t   order_ = 0;        // LPC order
-        int32_t   pos_ = 0;          // write index
         int32_t   K_ = 0;            // half-rate toggle
         float fs_ = 48000.0f;        // Store the sample rate
         float wet_gain_ = 0.5f;
         float dry_gain_ = 0.0f;
-        float emphasis_ = 0.0f;
-        float gender_ = 0.5f;
         float FX_ = 0.0f;
 
-        // Pre-emphasis and de-emphasis filter states
-        float d0_ = 0, d1_ = 0, d2_ = 0, d3_ = 0, d4_ = 0;
-        float u0_ = 0, u1_ = 0, u2_ = 0, u3_ = 0, u4_ = 0;
+        // Carrier pre-filter and output post-filter (the same all-pass)
+        AllPassCascade<1> prefilter_;
+        AllPassCascade<1> postfilter_;
 };
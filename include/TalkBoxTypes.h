@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+#include "AllPoleSynthesis.h"
+#include "LpcRecursion.h"
+
+
+// Largest frame. Every engine allocates its frames at this size in the
+// constructor, so init() at any sample rate and the processing never allocate.
+static constexpr int32_t BUF_MAX = 1600;
+static constexpr int32_t ORD_MAX = 50;
+static constexpr float TWO_PI = 6.28318530717958647692f;
+static constexpr int32_t STAGE_BLOCK = 64;      // processBlock() runs its stages on chunks of this many samples
+
+static_assert(ORD_MAX <= ALLPOLE_PAD, "direct-form synthesis history is too short for ORD_MAX");
+static_assert(ORD_MAX - 1 <= LPC_MAX_ORDER, "lpc_durbin()/lpc_schur() cannot run the highest order");
+
+
+// Analysis frame length N_ for a sample rate.
+// The magic number 0.01633f corresponds to ~784 samples at 48kHz.
+constexpr int32_t talkbox_frame_length(float fs) {
+    int32_t n = static_cast<int32_t>(0.01633f * fs);
+    return (n < BUF_MAX) ? n : BUF_MAX;     // Ensure it doesn't exceed buffer size
+}
+
+// Hann window of n points, as built by every engine: the phase is
+// accumulated in Sample precision, one increment of 2*pi/n per point, so
+// engines of the same Sample type get the same table to the last bit.
+// 'store' converts each value for the table (e.g. to fixed point).
+template <typename Sample, typename Out, typename Store>
+inline void talkbox_hann_window(Out* w, int32_t n, Store store) {
+    Sample dp    = Sample(TWO_PI) / static_cast<Sample>(n);
+    Sample phase = Sample(0);
+    for (int32_t i = 0; i < n; ++i) {
+        w[i]   = store(Sample(0.5) - Sample(0.5) * std::cos(phase));
+        phase += dp;
+    }
+}
+
+template <typename Sample>
+inline void talkbox_hann_window(Sample* w, int32_t n) {
+    talkbox_hann_window<Sample>(w, n, [](Sample v) { return v; });
+}
+
+// LPC order from the quality slider: order = (0.0001 + 0.0004 * quality) * fs,
+// clamped below ORD_MAX because lpc() and lpc_gender() use stack arrays of size ORD_MAX.
+constexpr int32_t talkbox_order(float fs, float quality) {
+    int32_t o = static_cast<int32_t>((0.0001f + 0.0004f * quality) * fs);
+    return (o < ORD_MAX - 1) ? o : ORD_MAX - 1;
+}
+
+
+// Autocorrelation backend used by the LPC analysis
+enum class AutocorrMethod {
+    Direct,     // register-tiled time-domain kernel, autocorr()
+    Fft         // zero-padded real FFT, FftAutocorrelator
+};
+
+
+// How the LPC analysis is scheduled
+enum class AnalysisMode {
+    Block,      // mda behaviour: windowed OLA frames, the whole LPC runs when a frame is full
+    Recursive   // Barnwell recursive window: r[] updated every decimated sample,
+                // Durbin every 'updateInterval' samples, lattice runs sample by sample
+};
+
+
+// Synthesis filter used for the block LPC frames
+enum class SynthesisMethod {
+    Lattice,    // mda lattice, reference path
+    DirectForm  // block all-pole filter (AllPoleFilter), falls back to the
+                // lattice for any frame that fails its stability check
+};
+
+
+// Recursion that turns r[] into the reflection coefficients
+enum class ReflectionMethod {
+    Durbin,     // mda Levinson-Durbin, lpc_durbin()
+    Schur       // Schur recursion, lpc_schur()
+};
+
+
+// How processBlock() keeps denormals out of the signal path
+enum class DenormalMode {
+    Flush,      // hardware flush-to-zero/denormals-are-zero for the duration of
+                // the block (ScopedDenormalFlush); falls back to Clamp on
+                // targets without it
+    Clamp       // mda behaviour: zero the all-pass states below 1e-10 after
+                // each block, nothing else is protected
+};
+
+
+// Statistics of the LPC order actually used, one entry per analysed frame
+// (Block mode) or per coefficient update (Recursive mode)
+struct LpcOrderStats {
+    uint32_t frames = 0;                // frames analysed (silent ones excluded)
+    uint32_t silent = 0;                // frames skipped by the silence check
+    uint64_t orderSum = 0;              // sum of the orders used
+    int32_t  minOrder = ORD_MAX;
+    int32_t  maxOrder = 0;
+    uint32_t histogram[ORD_MAX] = {0};  // number of frames per order used
+
+    float meanOrder() const { return frames ? static_cast<float>(orderSum) / frames : 0.0f; }
+};
+
+
+struct TalkBoxParams {
+    float wet     = 1.0f;       // [0..1]
+    float dry     = 0.0f;       // [0..1]
+    float quality = 1.0f;       // [0..1]
+    float gender  = 0.5f;       // [0=male, 0.5=norm, 1=female]
+};
+
+
+// LPC of one analysis frame: what LpcAnalyzer hands to LpcSynthesizer.
+// Plain data (no pointers), so it can be copied through a queue to another
+// thread, written to a file and read back, or produced by another analyzer.
+struct LpcFrameCoeffs {
+    uint32_t index = 0;         // frame number since LpcAnalyzer::init()
+    int32_t  order = 0;         // order actually used, k[1..order] are valid
+    float    G = 0.0f;          // lattice input gain
+    bool     silent = true;     // silence check failed: synthesize zeros
+    float    k[ORD_MAX] = {0};  // reflection coefficients, clamped to +-0.995
+};
+
+static_assert(std::is_trivially_copyable<LpcFrameCoeffs>::value, "LpcFrameCoeffs must stay plain data");
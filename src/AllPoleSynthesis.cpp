@@ -0,0 +1,176 @@
+#include "AllPoleSynthesis.h"
+#include "Simd.h"
+#include <cmath>
+
+
+void lattice_synth(const float* k, int32_t order, float G,
+                   const float* car, float* out, int32_t n)
+{
+    float z[ALLPOLE_PAD], x;
+    int32_t i, j;
+
+    for (j = 0; j <= order; j++) z[j] = 0.0f;
+
+    for (i = 0; i < n; i++)
+    {
+        x = G * car[i];
+        for (j = order; j > 0; j--)     //lattice filter
+        {
+            x -= k[j] * z[j - 1];
+            z[j] = z[j - 1] + k[j] * x;
+        }
+        out[i] = z[0] = x;
+    }
+}
+
+void reflection_to_predictor(const float* k, int32_t order, float* a)
+{
+    float at[ALLPOLE_PAD + 1];
+    int32_t i, j;
+
+    a[0] = 1.0f;
+    for (i = 1; i <= order; i++)
+    {
+        for (j = 1; j < i; j++) at[j] = a[j];
+        a[i] = k[i];
+        for (j = 1; j < i; j++) a[j] = at[j] + k[i] * at[i - j];
+    }
+}
+
+bool predictor_to_reflection(const float* a, int32_t order, float* k)
+{
+    float b[ALLPOLE_PAD + 1], bt[ALLPOLE_PAD + 1];
+    int32_t i, j;
+
+    for (j = 1; j <= order; j++) b[j] = a[j];
+
+    for (i = order; i > 0; i--)
+    {
+        k[i] = b[i];
+        float d = 1.0f - k[i] * k[i];
+        if (!(d > 0.0f)) return false;      // |k| >= 1 (or NaN)
+
+        for (j = 1; j < i; j++) bt[j] = b[j];
+        for (j = 1; j < i; j++) b[j] = (bt[j] - k[i] * bt[i - j]) / d;
+    }
+    return true;
+}
+
+
+bool AllPoleFilter::setCoeffs(const float* k, int32_t order, float tolerance)
+{
+    order_ = (order < ALLPOLE_PAD) ? order : ALLPOLE_PAD - 1;
+    len_   = (order_ + TALKBOX_SIMD_WIDTH - 1) / TALKBOX_SIMD_WIDTH * TALKBOX_SIMD_WIDTH;
+
+    reflection_to_predictor(k, order_, a_);
+
+    // Row m holds the history weights of output t+m. The window covers
+    // y[t-len_ .. t-1], so u = len_ + m - j for coefficient a[j]; the terms
+    // with j <= m point inside the current group and are left out here.
+    for (int32_t m = 0; m < 4; m++)
+    {
+        for (int32_t u = 0; u < len_; u++)
+        {
+            int32_t j = len_ + m - u;
+            rows_[m][u] = (j > m && j <= order_) ? a_[j] : 0.0f;
+        }
+    }
+
+    // Stability check against the lattice: the float polynomial must still
+    // step down to |k| < 1, and to the same coefficients the lattice uses.
+    float kc[ALLPOLE_PAD];
+    if (!predictor_to_reflection(a_, order_, kc)) return false;
+    for (int32_t j = 1; j <= order_; j++)
+        if (std::abs(kc[j] - k[j]) > tolerance) return false;
+
+    return true;
+}
+
+void AllPoleFilter::process(float G, const float* car, float* y, int32_t n) const
+{
+    const int32_t p = order_;
+    const int32_t len = len_;
+    const float a1 = (p >= 1) ? a_[1] : 0.0f;
+    const float a2 = (p >= 2) ? a_[2] : 0.0f;
+    const float a3 = (p >= 3) ? a_[3] : 0.0f;
+    int32_t t = 0;
+
+    for (int32_t u = 1; u <= len; u++) y[-u] = 0.0f;
+
+    for (; t + 4 <= n; t += 4)
+    {
+        const float* h = y + t - len;
+        float s0, s1, s2, s3;
+        int32_t u = 0;
+
+#if defined(TALKBOX_SIMD_AVX)
+        __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+        __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+        for (; u < len; u += 8)
+        {
+            __m256 hv = _mm256_loadu_ps(h + u);
+    #if defined(TALKBOX_SIMD_FMA)
+            c0 = _mm256_fmadd_ps(hv, _mm256_loadu_ps(rows_[0] + u), c0);
+            c1 = _mm256_fmadd_ps(hv, _mm256_loadu_ps(rows_[1] + u), c1);
+            c2 = _mm256_fmadd_ps(hv, _mm256_loadu_ps(rows_[2] + u), c2);
+            c3 = _mm256_fmadd_ps(hv, _mm256_loadu_ps(rows_[3] + u), c3);
+    #else
+            c0 = _mm256_add_ps(c0, _mm256_mul_ps(hv, _mm256_loadu_ps(rows_[0] + u)));
+            c1 = _mm256_add_ps(c1, _mm256_mul_ps(hv, _mm256_loadu_ps(rows_[1] + u)));
+            c2 = _mm256_add_ps(c2, _mm256_mul_ps(hv, _mm256_loadu_ps(rows_[2] + u)));
+            c3 = _mm256_add_ps(c3, _mm256_mul_ps(hv, _mm256_loadu_ps(rows_[3] + u)));
+    #endif
+        }
+        s0 = simd_hsum(c0); s1 = simd_hsum(c1); s2 = simd_hsum(c2); s3 = simd_hsum(c3);
+#elif defined(TALKBOX_SIMD_SSE)
+        __m128 c0 = _mm_setzero_ps(), c1 = _mm_setzero_ps();
+        __m128 c2 = _mm_setzero_ps(), c3 = _mm_setzero_ps();
+        for (; u < len; u += 4)
+        {
+            __m128 hv = _mm_loadu_ps(h + u);
+            c0 = _mm_add_ps(c0, _mm_mul_ps(hv, _mm_loadu_ps(rows_[0] + u)));
+            c1 = _mm_add_ps(c1, _mm_mul_ps(hv, _mm_loadu_ps(rows_[1] + u)));
+            c2 = _mm_add_ps(c2, _mm_mul_ps(hv, _mm_loadu_ps(rows_[2] + u)));
+            c3 = _mm_add_ps(c3, _mm_mul_ps(hv, _mm_loadu_ps(rows_[3] + u)));
+        }
+        s0 = simd_hsum(c0); s1 = simd_hsum(c1); s2 = simd_hsum(c2); s3 = simd_hsum(c3);
+#elif defined(TALKBOX_SIMD_NEON)
+        float32x4_t c0 = vdupq_n_f32(0.0f), c1 = vdupq_n_f32(0.0f);
+        float32x4_t c2 = vdupq_n_f32(0.0f), c3 = vdupq_n_f32(0.0f);
+        for (; u < len; u += 4)
+        {
+            float32x4_t hv = vld1q_f32(h + u);
+            c0 = vmlaq_f32(c0, hv, vld1q_f32(rows_[0] + u));
+            c1 = vmlaq_f32(c1, hv, vld1q_f32(rows_[1] + u));
+            c2 = vmlaq_f32(c2, hv, vld1q_f32(rows_[2] + u));
+            c3 = vmlaq_f32(c3, hv, vld1q_f32(rows_[3] + u));
+        }
+        s0 = simd_hsum(c0); s1 = simd_hsum(c1); s2 = simd_hsum(c2); s3 = simd_hsum(c3);
+#else
+        s0 = s1 = s2 = s3 = 0.0f;
+        for (; u < len; u++)
+        {
+            float hu = h[u];
+            s0 += hu * rows_[0][u];
+            s1 += hu * rows_[1][u];
+            s2 += hu * rows_[2][u];
+            s3 += hu * rows_[3][u];
+        }
+#endif
+
+        // Resolve the couplings inside the group
+        float y0 = G * car[t]     - s0;
+        float y1 = G * car[t + 1] - s1 - a1 * y0;
+        float y2 = G * car[t + 2] - s2 - a1 * y1 - a2 * y0;
+        float y3 = G * car[t + 3] - s3 - a1 * y2 - a2 * y1 - a3 * y0;
+        y[t] = y0;  y[t + 1] = y1;  y[t + 2] = y2;  y[t + 3] = y3;
+    }
+
+    // Last n % 4 outputs: plain recursion
+    for (; t < n; t++)
+    {
+        float s = G * car[t];
+        for (int32_t j = 1; j <= p; j++) s -= a_[j] * y[t - j];
+        y[t] = s;
+    }
+}
@@ -0,0 +1,389 @@
+#include "Autocorrelation.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+
+
+void autocorr_scalar(const float* x, int32_t n, int32_t maxLag, float* r)
+{
+    int32_t i, j, nn = n;
+
+    for (j = 0; j <= maxLag; j++, nn--)
+    {
+        r[j] = 0.0f;
+        for (i = 0; i < nn; i++) r[j] += x[i] * x[i + j];
+    }
+}
+
+
+// Compute r[j..j+3] in one pass. Requires j+3 <= n-1.
+// 'm' is the number of products that all four lags have in common;
+// the remaining 3/2/1 products of the shorter lags are added at the end.
+static void tile4(const float* x, int32_t n, int32_t j, float* r)
+{
+    const float* y = x + j;
+    const int32_t m = n - j - 3;
+    int32_t i = 0;
+
+    float s0, s1, s2, s3;
+
+#if defined(TALKBOX_SIMD_AVX)
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+    for (; i + 8 <= m; i += 8)
+    {
+        __m256 xv = _mm256_loadu_ps(x + i);
+    #if defined(TALKBOX_SIMD_FMA)
+        a0 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(y + i),     a0);
+        a1 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(y + i + 1), a1);
+        a2 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(y + i + 2), a2);
+        a3 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(y + i + 3), a3);
+    #else
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(xv, _mm256_loadu_ps(y + i)));
+        a1 = _mm256_add_ps(a1, _mm256_mul_ps(xv, _mm256_loadu_ps(y + i + 1)));
+        a2 = _mm256_add_ps(a2, _mm256_mul_ps(xv, _mm256_loadu_ps(y + i + 2)));
+        a3 = _mm256_add_ps(a3, _mm256_mul_ps(xv, _mm256_loadu_ps(y + i + 3)));
+    #endif
+    }
+    s0 = simd_hsum(a0); s1 = simd_hsum(a1); s2 = simd_hsum(a2); s3 = simd_hsum(a3);
+#elif defined(TALKBOX_SIMD_SSE)
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    __m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+    for (; i + 4 <= m; i += 4)
+    {
+        __m128 xv = _mm_loadu_ps(x + i);
+        a0 = _mm_add_ps(a0, _mm_mul_ps(xv, _mm_loadu_ps(y + i)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(xv, _mm_loadu_ps(y + i + 1)));
+        a2 = _mm_add_ps(a2, _mm_mul_ps(xv, _mm_loadu_ps(y + i + 2)));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(xv, _mm_loadu_ps(y + i + 3)));
+    }
+    s0 = simd_hsum(a0); s1 = simd_hsum(a1); s2 = simd_hsum(a2); s3 = simd_hsum(a3);
+#elif defined(TALKBOX_SIMD_NEON)
+    float32x4_t a0 = vdupq_n_f32(0.0f), a1 = vdupq_n_f32(0.0f);
+    float32x4_t a2 = vdupq_n_f32(0.0f), a3 = vdupq_n_f32(0.0f);
+    for (; i + 4 <= m; i += 4)
+    {
+        float32x4_t xv = vld1q_f32(x + i);
+        a0 = vmlaq_f32(a0, xv, vld1q_f32(y + i));
+        a1 = vmlaq_f32(a1, xv, vld1q_f32(y + i + 1));
+        a2 = vmlaq_f32(a2, xv, vld1q_f32(y + i + 2));
+        a3 = vmlaq_f32(a3, xv, vld1q_f32(y + i + 3));
+    }
+    s0 = simd_hsum(a0); s1 = simd_hsum(a1); s2 = simd_hsum(a2); s3 = simd_hsum(a3);
+#else
+    s0 = s1 = s2 = s3 = 0.0f;
+#endif
+
+    // Scalar remainder of the common range (and the whole range without SIMD)
+    for (; i < m; i++)
+    {
+        float xi = x[i];
+        s0 += xi * y[i];
+        s1 += xi * y[i + 1];
+        s2 += xi * y[i + 2];
+        s3 += xi * y[i + 3];
+    }
+
+    // Tails: lag j has 3 more products, lag j+1 has 2, lag j+2 has 1
+    for (i = m; i < m + 3; i++) s0 += x[i] * y[i];
+    for (i = m; i < m + 2; i++) s1 += x[i] * y[i + 1];
+    s2 += x[m] * y[m + 2];
+
+    r[j]     = s0;
+    r[j + 1] = s1;
+    r[j + 2] = s2;
+    r[j + 3] = s3;
+}
+
+// Single lag, used for the lags left over after tiling
+static float lag1(const float* x, int32_t n, int32_t j)
+{
+    const float* y = x + j;
+    const int32_t m = n - j;
+    int32_t i = 0;
+    float s;
+
+#if defined(TALKBOX_SIMD_AVX)
+    __m256 a = _mm256_setzero_ps();
+    for (; i + 8 <= m; i += 8)
+        a = _mm256_add_ps(a, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    s = simd_hsum(a);
+#elif defined(TALKBOX_SIMD_SSE)
+    __m128 a = _mm_setzero_ps();
+    for (; i + 4 <= m; i += 4)
+        a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    s = simd_hsum(a);
+#elif defined(TALKBOX_SIMD_NEON)
+    float32x4_t a = vdupq_n_f32(0.0f);
+    for (; i + 4 <= m; i += 4)
+        a = vmlaq_f32(a, vld1q_f32(x + i), vld1q_f32(y + i));
+    s = simd_hsum(a);
+#else
+    s = 0.0f;
+#endif
+
+    for (; i < m; i++) s += x[i] * y[i];
+    return s;
+}
+
+
+void autocorr_tiled(const float* x, int32_t n, int32_t maxLag, float* r)
+{
+    int32_t j = 0;
+
+    // Full tiles of 4 lags, as long as every lag in the tile has at least one product
+    for (; j + 3 <= maxLag && j + 3 < n; j += 4) tile4(x, n, j, r);
+
+    // Leftover lags
+    for (; j <= maxLag; j++) r[j] = (j < n) ? lag1(x, n, j) : 0.0f;
+}
+
+
+// ----------------------------------------------------------------------------
+// FFT backend
+// ----------------------------------------------------------------------------
+
+static int32_t next_pow2(int32_t v)
+{
+    int32_t m = 2;
+    while (m < v) m <<= 1;
+    return m;
+}
+
+FftAutocorrelator::FftAutocorrelator(int32_t maxN, int32_t maxLag)
+{
+    maxSize_ = next_pow2(maxN + maxLag);
+    int32_t h = maxSize_ / 2;
+
+    re_     = new float[h + 1];
+    im_     = new float[h + 1];
+    cos_    = new float[h];
+    sin_    = new float[h];
+    bitrev_ = new int32_t[h];
+
+    init(maxN, maxLag);
+}
+
+FftAutocorrelator::~FftAutocorrelator()
+{
+    delete[] re_;  delete[] im_;
+    delete[] cos_; delete[] sin_;
+    delete[] bitrev_;
+}
+
+void FftAutocorrelator::init(int32_t n, int32_t maxLag)
+{
+    size_ = std::min(next_pow2(n + maxLag), maxSize_);
+    const int32_t m = size_;
+    const int32_t h = m / 2;
+
+    // Twiddles W^k = exp(-2*pi*i*k/M). The half-size complex FFT uses every other one.
+    for (int32_t k = 0; k < h; k++)
+    {
+        double phase = 6.283185307179586 * k / m;
+        cos_[k] = static_cast<float>(std::cos(phase));
+        sin_[k] = static_cast<float>(std::sin(phase));
+    }
+
+    int32_t bits = 0;
+    while ((1 << bits) < h) bits++;
+    for (int32_t k = 0; k < h; k++)
+    {
+        int32_t rev = 0;
+        for (int32_t b = 0; b < bits; b++) rev |= ((k >> b) & 1) << (bits - 1 - b);
+        bitrev_[k] = rev;
+    }
+}
+
+// Iterative radix-2 decimation-in-time FFT of size M/2 (forward, unscaled)
+void FftAutocorrelator::fft(float* re, float* im) const
+{
+    const int32_t h = size_ / 2;
+
+    for (int32_t k = 0; k < h; k++)
+    {
+        int32_t j = bitrev_[k];
+        if (j > k)
+        {
+            std::swap(re[k], re[j]);
+            std::swap(im[k], im[j]);
+        }
+    }
+
+    for (int32_t len = 2; len <= h; len <<= 1)
+    {
+        const int32_t half   = len / 2;
+        const int32_t stride = 2 * (h / len);     // twiddle step in the size-M table
+        for (int32_t start = 0; start < h; start += len)
+        {
+            for (int32_t k = 0; k < half; k++)
+            {
+                float c = cos_[k * stride];
+                float s = sin_[k * stride];
+                int32_t a = start + k;
+                int32_t b = a + half;
+                // t = W * x[b], with W = c - i*s
+                float tr = re[b] * c + im[b] * s;
+                float ti = im[b] * c - re[b] * s;
+                re[b] = re[a] - tr;  im[b] = im[a] - ti;
+                re[a] += tr;         im[a] += ti;
+            }
+        }
+    }
+}
+
+void FftAutocorrelator::compute(const float* x, int32_t n, int32_t maxLag, float* r)
+{
+    if (n + maxLag > size_) { autocorr(x, n, maxLag, r); return; }
+
+    const int32_t h = size_ / 2;
+    int32_t k;
+
+    // Pack the real frame as h complex points: z[k] = x[2k] + i*x[2k+1], zero-padded
+    for (k = 0; 2 * k + 1 < n; k++) { re_[k] = x[2 * k]; im_[k] = x[2 * k + 1]; }
+    if (2 * k < n) { re_[k] = x[2 * k]; im_[k] = 0.0f; k++; }
+    for (; k < h; k++) re_[k] = im_[k] = 0.0f;
+
+    fft(re_, im_);
+
+    // Unpack into the real spectrum X[k] and keep only the power |X[k]|^2 in re_[0..h].
+    // Bins k and h-k are computed together because each needs both Z[k] and Z[h-k].
+    {
+        float z0r = re_[0], z0i = im_[0];
+        float x0 = z0r + z0i;               // X[0]
+        float xh = z0r - z0i;               // X[M/2]
+        re_[0] = x0 * x0;
+        re_[h] = xh * xh;
+    }
+    for (k = 1; k <= h / 2; k++)
+    {
+        const int32_t kk = h - k;
+        float ar = re_[k],  ai = im_[k];    // Z[k]
+        float br = re_[kk], bi = -im_[kk];  // conj(Z[h-k])
+        float c = cos_[k], s = sin_[k];
+
+        float fr = 0.5f * (ar + br), fi = 0.5f * (ai + bi);
+        float gr = 0.5f * (ar - br), gi = 0.5f * (ai - bi);
+
+        // X[k] = F - i*W^k*G
+        float xr  = fr - (s * gr - c * gi);
+        float xi  = fi - (s * gi + c * gr);
+        // X[h-k] = conj(F) + i*W^(h-k)*conj(G)... written out with W^(h-k) = -c - i*s
+        float yr  = fr + (s * gr - c * gi);
+        float yi  = -fi - (s * gi + c * gr);
+
+        re_[k]  = xr * xr + xi * xi;
+        re_[kk] = yr * yr + yi * yi;
+    }
+
+    // Repack the (real, even) power spectrum for the half-size inverse FFT:
+    //      Z'[k] = E[k] + i*O[k],   E = (P[k] + P[h-k]) / 2,   O = (P[k] - P[h-k]) * W^-k / 2
+    // and conjugate so the forward FFT computes the inverse.
+    {
+        float p0 = re_[0], ph = re_[h];
+        re_[0] = 0.5f * (p0 + ph);
+        im_[0] = -0.5f * (p0 - ph);
+    }
+    for (k = 1; k <= h / 2; k++)
+    {
+        const int32_t kk = h - k;
+        float pk = re_[k], pkk = re_[kk];
+        float e = 0.5f * (pk + pkk);
+        float d = 0.5f * (pk - pkk);
+        float c = cos_[k], s = sin_[k];
+
+        re_[k]  = e - d * s;   im_[k]  = -(d * c);
+        re_[kk] = e + d * s;   im_[kk] = -(d * c);
+    }
+
+    fft(re_, im_);
+
+    // y[2m] + i*y[2m+1] = conj(result) / h
+    const float scale = 1.0f / static_cast<float>(h);
+    for (int32_t j = 0; j <= maxLag; j++)
+    {
+        r[j] = (j & 1) ? -im_[j >> 1] * scale : re_[j >> 1] * scale;
+        if (j >= n) r[j] = 0.0f;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// Recursive backend
+// ----------------------------------------------------------------------------
+
+RecursiveAutocorrelator::RecursiveAutocorrelator(int32_t maxLag)
+{
+    lags_ = maxLag + 1;
+    hist_ = new float[2 * lags_];
+    s_    = new float[lags_];
+    r_    = new float[lags_];
+    lagwin_ = new float[lags_];
+    init(alpha_);
+}
+
+RecursiveAutocorrelator::~RecursiveAutocorrelator()
+{
+    delete[] hist_;
+    delete[] s_;
+    delete[] r_;
+    delete[] lagwin_;
+}
+
+void RecursiveAutocorrelator::init(float alpha)
+{
+    alpha_ = alpha;
+    for (int32_t j = 0; j < lags_; j++)
+        lagwin_[j] = static_cast<float>(std::pow(static_cast<double>(alpha), 0.5 * j));
+    reset();
+}
+
+void RecursiveAutocorrelator::reset()
+{
+    pos_ = 0;
+    for (int32_t j = 0; j < 2 * lags_; j++) hist_[j] = 0.0f;
+    for (int32_t j = 0; j < lags_; j++) s_[j] = r_[j] = 0.0f;
+}
+
+void RecursiveAutocorrelator::push(float x)
+{
+    // Newest sample goes in front, so h[j] = x(n-j)
+    pos_ = (pos_ == 0) ? lags_ - 1 : pos_ - 1;
+    hist_[pos_] = hist_[pos_ + lags_] = x;
+
+    const float* h = hist_ + pos_;
+    const float  a = alpha_;
+    for (int32_t j = 0; j < lags_; j++)
+    {
+        s_[j] = a * s_[j] + x * h[j];
+        r_[j] = a * r_[j] + s_[j];
+    }
+}
+
+void RecursiveAutocorrelator::read(float* r, int32_t maxLag, float scale)
+{
+    const float den = 1.0e-30f;
+    for (int32_t j = 0; j < lags_; j++)
+    {
+        if (std::abs(s_[j]) < den) s_[j] = 0.0f;
+        if (std::abs(r_[j]) < den) r_[j] = 0.0f;
+    }
+    for (int32_t j = 0; j <= maxLag && j < lags_; j++) r[j] = r_[j] * (scale * lagwin_[j]);
+    for (int32_t j = lags_; j <= maxLag; j++) r[j] = 0.0f;
+}
+
+void RecursiveAutocorrelator::saveState(StateWriter& w) const
+{
+    w.put(pos_);
+    w.put(hist_, 2 * lags_);
+    w.put(s_, lags_);
+    w.put(r_, lags_);
+}
+
+void RecursiveAutocorrelator::restoreState(StateReader& r)
+{
+    r.get(pos_);
+    r.get(hist_, 2 * lags_);
+    r.get(s_, lags_);
+    r.get(r_, lags_);
+}
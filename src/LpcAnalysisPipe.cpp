@@ -0,0 +1,138 @@
+#include "LpcAnalysisPipe.h"
+#include <cstring>
+
+
+LpcAnalysisPipe::LpcAnalysisPipe() {
+    jobs_    = new SpscQueue<Job, 4>();
+    results_ = new SpscQueue<LpcFrameCoeffs, 8>();
+    prev_    = new float[BUF_MAX];
+    memset(prev_,0,sizeof(float)*BUF_MAX);
+}
+
+LpcAnalysisPipe::~LpcAnalysisPipe() {
+    delete jobs_;
+    delete results_;
+    delete[] prev_;
+}
+
+void LpcAnalysisPipe::init(float sampleRate) {
+    worker_.init(sampleRate);
+    missed_.init(sampleRate);
+    N_ = worker_.frameLength();
+    jobs_->clear();
+    results_->clear();
+    next_index_ = 0;
+    has_prev_   = false;
+    prev_settings_ = Settings();
+    misses_     = 0;
+}
+
+LpcAnalysisPipe::Settings LpcAnalysisPipe::capture(const LpcAnalyzer& a) {
+    Settings s;
+    s.order      = a.order();
+    s.gender     = a.gender();
+    s.autocorr   = a.autocorrMethod();
+    s.reflection = a.reflectionMethod();
+    s.minError   = a.adaptiveOrder();
+    return s;
+}
+
+void LpcAnalysisPipe::apply(const Settings& s, LpcAnalyzer& a) {
+    a.setOrder(s.order);
+    a.setGender(s.gender);
+    a.setAutocorrMethod(s.autocorr);
+    a.setReflectionMethod(s.reflection);
+    a.setAdaptiveOrder(s.minError);
+}
+
+void LpcAnalysisPipe::exchange(LpcAnalyzer& local, const float* frame, LpcFrameCoeffs& out) {
+    // 1. Coefficients of the previous frame: from the worker if it is done
+    // (older, late results are dropped on the way), else analysed here with
+    // the settings it was queued with, which 'local' may no longer have
+    if (!has_prev_)
+    {
+        out = LpcFrameCoeffs();
+    }
+    else
+    {
+        const uint32_t want = next_index_ - 1;
+        bool got = false;
+        LpcFrameCoeffs r;
+        while (results_->pop(r))
+        {
+            if (r.index == want) { out = r; got = true; break; }
+        }
+
+        if (!got)
+        {
+            apply(prev_settings_, missed_);
+            missed_.analyze(prev_, out);
+            misses_++;
+        }
+        local.recordFrame(out);
+        out.index = want;
+    }
+
+    // 2. Queue this frame, and keep a copy for a miss
+    memcpy(prev_, frame, N_ * sizeof(float));
+    prev_settings_ = capture(local);
+    has_prev_ = true;
+
+    Job* job = jobs_->writeSlot();
+    if (job)
+    {
+        job->index    = next_index_;
+        job->settings = prev_settings_;
+        memcpy(job->x, frame, N_ * sizeof(float));
+        jobs_->publish();
+    }
+    next_index_++;
+}
+
+void LpcAnalysisPipe::writeState(StateWriter& w, bool hasPrev, const Settings& settings, const float* prev, int32_t N) {
+    w.put(hasPrev);
+    w.put(settings);
+    w.put(prev, N);
+}
+
+void LpcAnalysisPipe::saveState(StateWriter& w) const {
+    writeState(w, has_prev_, prev_settings_, prev_, N_);
+}
+
+// A counting writer never reads the frame, so any pointer will do
+size_t LpcAnalysisPipe::stateBytes(int32_t N) {
+    static const float none = 0.0f;
+    StateWriter w(nullptr, 0);
+    writeState(w, false, Settings(), &none, N);
+    return w.size();
+}
+
+void LpcAnalysisPipe::restoreState(StateReader& r) {
+    r.get(has_prev_);
+    r.get(prev_settings_);
+    r.get(prev_, N_);
+
+    // Skip an index that was never queued: exchange() then finds no match,
+    // drops every older result and analyses the restored frame itself
+    next_index_++;
+}
+
+void LpcAnalysisPipe::restart() {
+    has_prev_ = false;
+    next_index_++;
+}
+
+bool LpcAnalysisPipe::service() {
+    const Job* job = jobs_->front();
+    if (!job) return false;
+
+    apply(job->settings, worker_);
+
+    LpcFrameCoeffs r;
+    worker_.analyze(job->x, r);
+    r.index = job->index;
+    jobs_->release();
+
+    results_->push(r);      // if the audio thread stopped collecting, it analyses itself
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "LpcAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+LpcAnalyzer::LpcAnalyzer() : fft_(BUF_MAX, ORD_MAX - 1) {
+    buf0_       = new float[BUF_MAX];
+    buf1_       = new float[BUF_MAX];
+    window_     = new float[BUF_MAX];
+    gender_buf_ = new float[BUF_MAX];
+
+    memset(buf0_,0,sizeof(float)*BUF_MAX);
+    memset(buf1_,0,sizeof(float)*BUF_MAX);
+}
+
+LpcAnalyzer::~LpcAnalyzer() {
+    delete[] buf0_;
+    delete[] buf1_;
+    delete[] window_;
+    delete[] gender_buf_;
+}
+
+void LpcAnalyzer::init(float sampleRate) {
+    N_ = talkbox_frame_length(std::clamp(sampleRate, 8000.0f, 96000.0f));
+
+    // Hanning window, same as the synthesis side
+    talkbox_hann_window(window_, N_);
+
+    // Size the FFT backend for this frame length and any order up to ORD_MAX-1,
+    // so later changes of quality never need a re-init.
+    fft_.init(N_, ORD_MAX - 1);
+
+    // Empty frames, so a re-initialized analyzer starts like a new one
+    memset(buf0_,0,sizeof(float)*BUF_MAX);
+    memset(buf1_,0,sizeof(float)*BUF_MAX);
+
+    order_stats_ = LpcOrderStats();
+    pos_      = 0;
+    frames_   = 0;
+    emphasis_ = 0.0f;
+}
+
+void LpcAnalyzer::setOrder(int32_t order) {
+    order_ = std::clamp(order, (int32_t)0, ORD_MAX - 1);
+}
+
+void LpcAnalyzer::setAdaptiveOrder(float minError) {
+    min_error_ = std::max(minError, 0.0f);
+}
+
+void LpcAnalyzer::emphasize(const float* in, float* out, int32_t count) {
+    if (count <= 0) return;
+    float prev = emphasis_;
+    emphasis_ = in[count - 1];
+    for (int32_t i = 0; i < count; i++)
+    {
+        float m = in[i];
+        out[i] = m - prev;
+        prev = m;
+    }
+}
+
+int32_t LpcAnalyzer::samplesToFrame() const {
+    int32_t p1 = (pos_ + N_/2) % N_;      // 50% offset pointer
+    return std::min(N_ - pos_, N_ - p1);
+}
+
+bool LpcAnalyzer::process(const float* e, int32_t n, LpcFrameCoeffs& frame) {
+    const float* buf = window(e, n);
+    if (!buf) return false;
+    analyze(buf, frame);
+    return true;
+}
+
+// buf0_ gets the window, buf1_ the complementary window; the frame that
+// reaches N_ is complete
+const float* LpcAnalyzer::window(const float* e, int32_t n) {
+    int32_t p0 = pos_;
+    int32_t p1 = (pos_ + N_/2) % N_;
+    const float* w = window_ + p0;
+    float* b0 = buf0_ + p0;
+    float* b1 = buf1_ + p1;
+
+    for (int32_t j = 0; j < n; j++)
+    {
+        float w0 = w[j];
+        b0[j] = e[j] * w0;
+        b1[j] = e[j] * (1.0f - w0);
+    }
+
+    p0 += n;
+    p1 += n;
+    pos_ = (p0 >= N_) ? 0 : p0;
+
+    if (p0 >= N_) return buf0_;
+    if (p1 >= N_) return buf1_;
+    return nullptr;
+}
+
+// LPC of a full frame (mda lpc_gender() without the synthesis)
+void LpcAnalyzer::analyze(const float* buf, LpcFrameCoeffs& frame) {
+    const int32_t n = N_;
+    const float* x = buf;
+
+    // Resample the frame for formant shifting; at the neutral setting the
+    // frame is analysed as it is
+    if (lpc_gender_resample(buf, n, gender_, gender_buf_)) x = gender_buf_;
+
+    float r[ORD_MAX];
+    if (autocorr_method_ == AutocorrMethod::Fft) fft_.compute(x, n, order_, r);
+    else                                         autocorr(x, n, order_, r);
+
+    coefficients(r, order_, frame);
+}
+
+void LpcAnalyzer::coefficients(float* r, int32_t order, LpcFrameCoeffs& frame) {
+    frame.index = frames_++;
+    r[0] *= 1.001f;     //stability fix
+
+    float min = 0.00001f;
+    if (r[0] < min)
+    {
+        frame.silent = true;
+        frame.order  = 0;
+        frame.G      = 0.0f;
+        recordFrame(frame);
+        return;
+    }
+
+    //calc reflection coeffs, o = order actually used
+    int32_t o;
+    if (refl_method_ == ReflectionMethod::Schur) o = lpc_schur(r, order, frame.k, &frame.G, min_error_);
+    else                                          o = lpc_durbin(r, order, frame.k, &frame.G, min_error_);
+
+    for (int32_t i = 0; i <= o; i++)
+    {
+        if (frame.k[i] > 0.995f) frame.k[i] = 0.995f; else if (frame.k[i] < -0.995f) frame.k[i] = -.995f;
+    }
+    frame.order  = o;
+    frame.silent = false;
+    recordFrame(frame);
+}
+
+void LpcAnalyzer::recordFrame(const LpcFrameCoeffs& frame) {
+    if (frame.silent) { order_stats_.silent++; return; }
+
+    int32_t o = frame.order;
+    order_stats_.frames++;
+    order_stats_.orderSum += o;
+    order_stats_.histogram[o]++;
+    order_stats_.minOrder = std::min(order_stats_.minOrder, o);
+    order_stats_.maxOrder = std::max(order_stats_.maxOrder, o);
+}
+
+// Both frames are kept whole: the filled part of each depends on the
+// position, and a fixed size lets the caller allocate a snapshot once
+void LpcAnalyzer::saveState(StateWriter& w) const {
+    w.put(pos_);
+    w.put(frames_);
+    w.put(emphasis_);
+    w.put(buf0_, N_);
+    w.put(buf1_, N_);
+}
+
+void LpcAnalyzer::restoreState(StateReader& r) {
+    r.get(pos_);
+    r.get(frames_);
+    r.get(emphasis_);
+    r.get(buf0_, N_);
+    r.get(buf1_, N_);
+}
@@ -0,0 +1,76 @@
+#include "LpcRecursion.h"
+#include <cmath>
+
+
+template <typename T>
+int32_t lpc_durbin(const T* r, int32_t p, T* k, T* g, T minError)
+{
+    int32_t i, j, used = p;
+    T a[LPC_MAX_ORDER + 1], at[LPC_MAX_ORDER + 1], e = r[0];
+    T stop = minError * r[0];
+
+    for (i = 0; i <= p; i++) a[i] = at[i] = T(0); //probably don't need to clear at[] or k[]
+    k[0] = T(0);
+
+    for (i = 1; i <= p; i++)
+    {
+        k[i] = -r[i];
+
+        for (j = 1; j < i; j++)
+        {
+            at[j] = a[j];
+            k[i] -= a[j] * r[i - j];
+        }
+        if (std::fabs(e) < T(1.0e-20f)) { e = T(0); used = i - 1; break; }
+        k[i] /= e;
+
+        a[i] = k[i];
+        for (j = 1; j < i; j++) a[j] = at[j] + k[i] * at[i - j];
+
+        e *= T(1) - k[i] * k[i];
+        if (minError > T(0) && e < stop) { used = i; break; }   // good enough at this order
+    }
+    for (i = used + 1; i <= p; i++) k[i] = T(0);    // stopped early: no further stages
+
+    if (e < T(1.0e-20f)) e = T(0);
+    *g = std::sqrt(e);
+    return used;
+}
+
+template int32_t lpc_durbin<float>(const float*, int32_t, float*, float*, float);
+template int32_t lpc_durbin<double>(const double*, int32_t, double*, double*, double);
+
+int32_t lpc_schur(const float* r, int32_t p, float* k, float* g, float minError)
+{
+    // U[j] holds U_{i-1}[j]. V is stored shifted: at step i, V[m] holds
+    // V_{i-1}[m + i - 1], so the divisor is always V[0] and the update
+    // pairs U[j] with V[j - i] -- two contiguous, non-overlapping runs.
+    float U[LPC_MAX_ORDER + 1], V[LPC_MAX_ORDER + 1] = {0};
+    int32_t i, j, used = p;
+    float stop = minError * r[0];
+
+    for (j = 0; j <= p; j++) U[j] = V[j] = r[j];
+    k[0] = 0.0f;
+
+    for (i = 1; i <= p; i++)
+    {
+        if (std::fabs(V[0]) < 1.0e-20f) { used = i - 1; break; }
+        float ki = -U[i] / V[0];
+        k[i] = ki;
+
+        for (j = i; j <= p; j++)
+        {
+            float uj = U[j], vj = V[j - i];
+            U[j]     = uj + ki * vj;
+            V[j - i] = vj + ki * uj;
+        }
+        if (minError > 0.0f && V[0] < stop) { used = i; break; }
+    }
+
+    float e = V[0];
+    for (i = used + 1; i <= p; i++) k[i] = 0.0f;
+
+    if (e < 1.0e-20f) e = 0.0f;
+    *g = std::sqrt(e);
+    return used;
+}
@@ -0,0 +1,127 @@
+#include "LpcSynthesizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+LpcSynthesizer::LpcSynthesizer() {
+    buf0_      = new float[BUF_MAX];
+    buf1_      = new float[BUF_MAX];
+    car0_      = new float[BUF_MAX];
+    car1_      = new float[BUF_MAX];
+    window_    = new float[BUF_MAX];
+    synth_buf_ = new float[ALLPOLE_PAD + BUF_MAX];
+
+    // Silence until the first frames are synthesized
+    memset(buf0_,0,sizeof(float)*BUF_MAX);
+    memset(buf1_,0,sizeof(float)*BUF_MAX);
+    memset(car0_,0,sizeof(float)*BUF_MAX);
+    memset(car1_,0,sizeof(float)*BUF_MAX);
+}
+
+LpcSynthesizer::~LpcSynthesizer() {
+    delete[] buf0_; delete[] car0_;
+    delete[] buf1_; delete[] car1_;
+    delete[] window_;
+    delete[] synth_buf_;
+}
+
+void LpcSynthesizer::init(float sampleRate) {
+    N_ = talkbox_frame_length(std::clamp(sampleRate, 8000.0f, 96000.0f));
+
+    // Hanning window, same as the analysis side
+    talkbox_hann_window(window_, N_);
+
+    // Silence again until the first frames are synthesized
+    memset(buf0_,0,sizeof(float)*BUF_MAX);
+    memset(buf1_,0,sizeof(float)*BUF_MAX);
+    memset(car0_,0,sizeof(float)*BUF_MAX);
+    memset(car1_,0,sizeof(float)*BUF_MAX);
+
+    pos_ = 0;
+    pending_ = pending_car_ = nullptr;
+    synth_fallbacks_ = 0;
+}
+
+int32_t LpcSynthesizer::samplesToFrame() const {
+    int32_t p1 = (pos_ + N_/2) % N_;      // 50% offset pointer
+    return std::min(N_ - pos_, N_ - p1);
+}
+
+bool LpcSynthesizer::process(const float* car, float* out, int32_t n) {
+    int32_t p0 = pos_;
+    int32_t p1 = (pos_ + N_/2) % N_;
+    const float* w  = window_ + p0;
+    const float* b0 = buf0_ + p0;
+    const float* b1 = buf1_ + p1;
+
+    // Capture the filtered carrier into both frames.
+    memcpy(car0_ + p0, car, n * sizeof(float));
+    memcpy(car1_ + p1, car, n * sizeof(float));
+
+    // Overlap-add: buf0_ fades out with the window, buf1_ with the
+    // complementary window
+    for (int32_t j = 0; j < n; j++)
+    {
+        float w0 = w[j];
+        float y  = b0[j] * w0;
+        y       += b1[j] * (1.0f - w0);
+        out[j] = y;
+    }
+
+    p0 += n;
+    p1 += n;
+    pos_ = (p0 >= N_) ? 0 : p0;
+
+    if (p0 >= N_) { pending_ = buf0_; pending_car_ = car0_; return true; }
+    if (p1 >= N_) { pending_ = buf1_; pending_car_ = car1_; return true; }
+    return false;
+}
+
+// G * car[] through 1/A(z) into the pending output frame
+void LpcSynthesizer::synthesize(const LpcFrameCoeffs& frame) {
+    float* buf = pending_;
+    const float* car = pending_car_;
+    pending_ = pending_car_ = nullptr;
+    if (!buf) return;
+
+    if (frame.silent) { memset(buf, 0, N_ * sizeof(float)); return; }
+
+    if (synth_method_ == SynthesisMethod::DirectForm)
+    {
+        if (allpole_.setCoeffs(frame.k, frame.order))
+        {
+            float* y = synth_buf_ + ALLPOLE_PAD;
+            allpole_.process(frame.G, car, y, N_);
+            memcpy(buf, y, N_ * sizeof(float));
+            return;
+        }
+        synth_fallbacks_++;     // coefficients too ill-conditioned for direct form
+    }
+
+    lattice_synth(frame.k, frame.order, frame.G, car, buf, N_);
+}
+
+// Only what is still to be read is state: the carrier captured so far
+// (before the write position of each frame) and the synthesized output
+// still to be faded out (from it on). That is 2 * N_ floats at any position.
+void LpcSynthesizer::saveState(StateWriter& w) const {
+    int32_t p0 = pos_;
+    int32_t p1 = (pos_ + N_/2) % N_;
+    w.put(pos_);
+    w.put(car0_, p0);
+    w.put(car1_, p1);
+    w.put(buf0_ + p0, N_ - p0);
+    w.put(buf1_ + p1, N_ - p1);
+}
+
+void LpcSynthesizer::restoreState(StateReader& r) {
+    r.get(pos_);
+    int32_t p0 = pos_;
+    int32_t p1 = (pos_ + N_/2) % N_;
+    r.get(car0_, p0);
+    r.get(car1_, p1);
+    r.get(buf0_ + p0, N_ - p0);
+    r.get(buf1_ + p1, N_ - p1);
+    pending_ = pending_car_ = nullptr;
+}
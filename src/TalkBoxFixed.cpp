@@ -0,0 +1,362 @@
+#include "TalkBoxFixed.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+
+// Fixed-point formats (see TalkBoxFixed.h)
+static constexpr int32_t SIG_FRAC  = 24;            // Q7.24 signal
+static constexpr int32_t CAR_FRAC  = 14;            // Q1.14 carrier buffers
+static constexpr int32_t ONE_Q30   = 1 << 30;
+static constexpr int32_t ONE_Q16   = 1 << 16;
+static constexpr int32_t K_MAX_Q31 = 2136746229;    // 0.995 in Q31
+static constexpr int32_t AC_BITS   = 20;            // frame peak before the autocorrelation, keeps 64-bit sums safe up to BUF_MAX
+
+// Silence threshold of lpc(): r[0] < 0.00001 with r[] in Q48 (Q24 * Q24)
+static constexpr int64_t SILENCE_Q48 = 2814749767LL;
+
+
+// Saturating helpers
+static inline int32_t sat32(int64_t x)
+{
+    return (x > INT32_MAX) ? INT32_MAX : (x < INT32_MIN) ? INT32_MIN : static_cast<int32_t>(x);
+}
+
+static inline int16_t sat16(int32_t x)
+{
+    return (x > INT16_MAX) ? INT16_MAX : (x < INT16_MIN) ? INT16_MIN : static_cast<int16_t>(x);
+}
+
+static inline int32_t add_sat(int32_t a, int32_t b) { return sat32(static_cast<int64_t>(a) + b); }
+static inline int32_t sub_sat(int32_t a, int32_t b) { return sat32(static_cast<int64_t>(a) - b); }
+
+// Q31 coefficient times any Qn value, result in Qn
+static inline int32_t mul31(int32_t coef, int32_t x)
+{
+    return static_cast<int32_t>((static_cast<int64_t>(coef) * x) >> 31);
+}
+
+// Q30 window times any Qn value, result in Qn
+static inline int32_t mul30(int32_t w, int32_t x)
+{
+    return static_cast<int32_t>((static_cast<int64_t>(w) * x) >> 30);
+}
+
+static inline int32_t bit_length(int64_t v)
+{
+    int32_t b = 0;
+    while (b < 63 && (v >> b) != 0) b++;
+    return b;
+}
+
+// Integer square root (floor) of a 64-bit value
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t res = 0, bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit)
+    {
+        if (v >= res + bit) { v -= res + bit; res = (res >> 1) + bit; }
+        else res >>= 1;
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(res);
+}
+
+
+// I/O conversion for the two processBlock() flavours
+static inline int32_t to_q24(float x)
+{
+    x = std::min(std::max(x, -127.0f), 127.0f);
+    return static_cast<int32_t>(x * 16777216.0f);
+}
+static inline int32_t to_q24(int32_t x) { return x >> (31 - SIG_FRAC); }
+
+static inline void from_q24(int32_t v, float& out)   { out = static_cast<float>(v) * (1.0f / 16777216.0f); }
+static inline void from_q24(int32_t v, int32_t& out) { out = sat32(static_cast<int64_t>(v) << (31 - SIG_FRAC)); }
+
+
+// Class constructor
+TalkBoxFixed::TalkBoxFixed() {
+    buf0_   = new int32_t[BUF_MAX];
+    buf1_   = new int32_t[BUF_MAX];
+    car0_   = new int16_t[BUF_MAX];
+    car1_   = new int16_t[BUF_MAX];
+    window_ = new int32_t[BUF_MAX];
+    frame_  = new int32_t[BUF_MAX];
+
+    N_ = 0;
+    K_ = 0;
+
+    memset(buf0_,0,sizeof(int32_t)*BUF_MAX);
+    memset(buf1_,0,sizeof(int32_t)*BUF_MAX);
+    memset(car0_,0,sizeof(int16_t)*BUF_MAX);
+    memset(car1_,0,sizeof(int16_t)*BUF_MAX);
+}
+
+// Class destructor
+TalkBoxFixed::~TalkBoxFixed() {
+    delete[] buf0_; delete[] car0_;
+    delete[] buf1_; delete[] car1_;
+    delete[] window_;
+    delete[] frame_;
+}
+
+// Parameters update method (control rate, so float math is fine here)
+void TalkBoxFixed::updateParams(const TalkBoxParams& params) {
+    order_ = talkbox_order(fs_, params.quality);
+
+    wet_gain_ = static_cast<int32_t>(0.5f * params.wet * params.wet * 536870912.0f);    // Q29
+    dry_gain_ = static_cast<int32_t>(2.0f * params.dry * params.dry * 536870912.0f);
+
+    float ratio = 1.0f + (-0.5f + params.gender);
+    ratio_ = (std::abs(ratio - 1.0f) < 0.001f) ? ONE_Q16 : static_cast<int32_t>(ratio * 65536.0f);
+}
+
+// Class initialization method
+void TalkBoxFixed::init(float sampleRate, const TalkBoxParams& params) {
+    fs_ = std::clamp(sampleRate, 8000.0f, 96000.0f);
+
+    N_ = talkbox_frame_length(fs_);
+
+    // Same Hann window as the float engine, stored in Q30
+    talkbox_hann_window<float>(window_, N_, [](float w) {
+        return static_cast<int32_t>(static_cast<double>(w) * ONE_Q30);
+    });
+
+    updateParams(params);
+
+    pos_      = 0;
+    K_        = 0;
+    emphasis_ = 0;
+    FX_       = 0;
+
+    d0_ = d1_ = d2_ = d3_ = d4_ = 0;
+    u0_ = u1_ = u2_ = u3_ = u4_ = 0;
+
+    // Empty frames, so a re-initialized engine starts like a new one
+    memset(buf0_,0,sizeof(int32_t)*BUF_MAX);
+    memset(buf1_,0,sizeof(int32_t)*BUF_MAX);
+    memset(car0_,0,sizeof(int16_t)*BUF_MAX);
+    memset(car1_,0,sizeof(int16_t)*BUF_MAX);
+}
+
+void TalkBoxFixed::processBlock(const float* modIn, const float* carIn,
+                                float* outL, float* outR, int32_t frames)
+{
+    process(modIn, carIn, outL, outR, frames);
+}
+
+void TalkBoxFixed::processBlock(const int32_t* modIn, const int32_t* carIn,
+                                int32_t* outL, int32_t* outR, int32_t frames)
+{
+    process(modIn, carIn, outL, outR, frames);
+}
+
+// Same per-sample structure as TalkBoxProcessor::processBlock()
+template <typename Sample>
+void TalkBoxFixed::process(const Sample* modIn, const Sample* carIn,
+                           Sample* outL, Sample* outR, int32_t frames)
+{
+    int32_t p0   = pos_;
+    int32_t p1   = (pos_ + N_/2) % N_;
+    int32_t emph = emphasis_;
+    int32_t fx   = FX_;
+
+    // All-pass coefficients 0.3 and 0.77 in Q31
+    const int32_t h0 = 644245094;
+    const int32_t h1 = 1653562409;
+
+    for (int32_t n = 0; n < frames; ++n)
+    {
+        int32_t m   = to_q24(modIn[n]);
+        int32_t c   = to_q24(carIn[n]);
+        int32_t dry = m;
+
+        // Pre-filter the carrier
+        {
+            int32_t p = add_sat(d0_, mul31(h0, c));
+            d0_ = d1_;  d1_ = sub_sat(c, mul31(h0, p));
+            int32_t q = add_sat(d2_, mul31(h1, d4_));
+            d2_ = d3_;  d3_ = sub_sat(d4_, mul31(h1, q));
+            d4_ = c;
+            c = add_sat(p, q);
+        }
+
+        // Half-rate LPC
+        if (K_++)
+        {
+            K_ = 0;
+
+            car0_[p0] = car1_[p1] = sat16(c >> (SIG_FRAC - CAR_FRAC));
+
+            // Pre-emphasis
+            c = sub_sat(m, emph);
+            emph = m;
+
+            int32_t w = window_[p0];
+            fx = mul30(w, buf0_[p0]);
+            buf0_[p0] = mul30(w, c);
+
+            if (++p0 >= N_)
+            {
+                lpc_gender(buf0_, car0_, N_, order_);
+                p0 = 0;
+            }
+
+            int32_t w2 = ONE_Q30 - w;
+            fx = add_sat(fx, mul30(w2, buf1_[p1]));
+            buf1_[p1] = mul30(w2, c);
+
+            if (++p1 >= N_)
+            {
+                lpc_gender(buf1_, car1_, N_, order_);
+                p1 = 0;
+            }
+        }
+
+        // Post-filter
+        {
+            int32_t p = add_sat(u0_, mul31(h0, fx));
+            u0_ = u1_;  u1_ = sub_sat(fx, mul31(h0, p));
+            int32_t q = add_sat(u2_, mul31(h1, u4_));
+            u2_ = u3_;  u3_ = sub_sat(u4_, mul31(h1, q));
+            u4_ = fx;
+            c = add_sat(p, q);
+        }
+
+        // Mix wet + dry (Q29 gains)
+        int32_t out = sat32((static_cast<int64_t>(wet_gain_) * c +
+                             static_cast<int64_t>(dry_gain_) * dry) >> 29);
+
+        from_q24(out, outL[n]);
+        from_q24(out, outR[n]);
+    }
+
+    pos_      = p0;
+    emphasis_ = emph;
+    FX_       = fx;
+}
+
+
+void TalkBoxFixed::lpc_gender(int32_t* buf, const int16_t* car, int32_t n, int32_t o)
+{
+    int64_t r[ORD_MAX], err;
+    int32_t rq[ORD_MAX] = {0}, k[ORD_MAX], z[ORD_MAX];
+    int32_t i, j;
+
+    // Formant shift: linear-interpolation resampling with a Q16 read position
+    if (ratio_ == ONE_Q16)
+    {
+        memcpy(frame_, buf, n * sizeof(int32_t));
+    }
+    else
+    {
+        const int32_t last = (n - 1) << 16;
+        int32_t read_pos = 0;
+        for (i = 0; i < n; i++)
+        {
+            int32_t cp   = std::min(read_pos, last);
+            int32_t i0   = cp >> 16;
+            int32_t frac = cp & 0xFFFF;
+            int32_t i1   = std::min(i0 + 1, n - 1);
+            frame_[i] = buf[i0] + static_cast<int32_t>((static_cast<int64_t>(buf[i1] - buf[i0]) * frac) >> 16);
+            read_pos += ratio_;
+        }
+    }
+
+    // Block normalization: bring the frame peak below 2^AC_BITS so that
+    // n products of two samples can be summed in 64 bits without overflow.
+    int32_t peak = 0;
+    for (i = 0; i < n; i++) peak = std::max(peak, std::abs(frame_[i]));
+    int32_t sa = 0;
+    while ((peak >> sa) >= (1 << AC_BITS)) sa++;
+    if (sa > 0) for (i = 0; i < n; i++) frame_[i] >>= sa;
+
+    // Autocorrelation, 64-bit accumulation
+    for (j = 0; j <= o; j++)
+    {
+        int64_t acc = 0;
+        for (i = 0; i < n - j; i++) acc += static_cast<int64_t>(frame_[i]) * frame_[i + j];
+        r[j] = acc;
+        z[j] = 0;
+    }
+    r[0] += r[0] >> 10;     //stability fix (x1.001)
+
+    if (r[0] < (SILENCE_Q48 >> (2 * sa))) { for (i = 0; i < n; i++) buf[i] = 0; return; }
+
+    // Normalize to Q31 with r[0] in [2^30, 2^31)
+    int32_t sh = bit_length(r[0]) - 31;
+    for (j = 0; j <= o; j++) rq[j] = static_cast<int32_t>(sh >= 0 ? (r[j] >> sh) : (r[j] << -sh));
+
+    lpc_schur(rq, o, k, &err);     //calc reflection coeffs
+
+    for (i = 0; i <= o; i++)
+    {
+        if (k[i] > K_MAX_Q31) k[i] = K_MAX_Q31; else if (k[i] < -K_MAX_Q31) k[i] = -K_MAX_Q31;
+    }
+
+    // Gain G = sqrt(e). e is in units of 2^t of the real-valued energy:
+    //      t = sh (Q31 normalization) + 2*sa (block scaling) - 2*SIG_FRAC
+    // With t even, G = isqrt(e << 30) * 2^(t/2 - 15).
+    int32_t t = sh + 2 * sa - 2 * SIG_FRAC;
+    uint64_t e = static_cast<uint64_t>(std::max(err, static_cast<int64_t>(0)));
+    if (t & 1) { e <<= 1; t -= 1; }
+    int64_t g = isqrt64(e << 30);
+
+    // x = G * car, from Q1.14 to Q7.24: shift by (15 - t/2) - (SIG_FRAC - CAR_FRAC)
+    int32_t gs = 15 - t / 2 - (SIG_FRAC - CAR_FRAC);
+
+    for (i = 0; i < n; i++)
+    {
+        int64_t xg = static_cast<int64_t>(car[i]) * g;
+        int32_t x  = sat32(gs >= 0 ? (xg >> gs) : (xg << -gs));
+
+        for (j = o; j > 0; j--)     //saturating lattice filter
+        {
+            x = sub_sat(x, mul31(k[j], z[j - 1]));
+            z[j] = add_sat(z[j - 1], mul31(k[j], x));
+        }
+        buf[i] = z[0] = x;
+    }
+}
+
+
+// Schur recursion in Q31.
+// U[j] and V[j] are the correlations of the forward and backward
+// prediction errors with the input; each stage zeroes U[i], which gives
+//      k[i] = -U[i] / V[i-1]
+// and updates (j = p..i, descending so V[j-1] is still the old value)
+//      U[j] <- U[j] + k[i] * V[j-1]
+//      V[j] <- V[j-1] + k[i] * U[j]
+// The values stay bounded by r[0], so Q31 needs no rescaling between
+// stages. 'err' receives the final prediction error energy V[p].
+void TalkBoxFixed::lpc_schur(const int32_t* r, int32_t p, int32_t* k, int64_t* err)
+{
+    int32_t U[ORD_MAX], V[ORD_MAX] = {0};
+    int32_t i, j;
+
+    for (j = 0; j <= p; j++) U[j] = V[j] = r[j];
+    k[0] = 0;
+
+    for (i = 1; i <= p; i++)
+    {
+        if (V[i - 1] <= 0) break;
+
+        int64_t q = -(static_cast<int64_t>(U[i]) * (1LL << 31)) / V[i - 1];
+        int32_t ki = sat32(q);
+        k[i] = ki;
+
+        for (j = p; j >= i; j--)
+        {
+            int32_t u = U[j], v = V[j - 1];
+            U[j] = add_sat(u, mul31(ki, v));
+            V[j] = add_sat(v, mul31(ki, u));
+        }
+    }
+
+    *err = V[i - 1];
+    for (; i <= p; i++) k[i] = 0;
+}
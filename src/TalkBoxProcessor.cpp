@@ -6,57 +6,72 @@ using namespace std;
 
 
 // Class constructor
-TalkBoxProcessor::TalkBoxProcessor() {       
-    // Allocate memory for the four main overlap-add (OLA) buffers.
-    // - buf0_/buf1_ hold the *modulator* (voice) signal, windowed.
-    //   They are later overwritten by the synthesized (vocoded) output.
-    // - car0_/car1_ hold the *carrier* (synth) signal.
-    // - gender_buf_ is needed for the buffer replacing formant shifting of lpc_gender().
-    buf0_       = new float[BUF_MAX];               // Allocate memory for the buffers
-    car0_       = new float[BUF_MAX];
-    buf1_       = new float[BUF_MAX];
-    car1_       = new float[BUF_MAX];
-    gender_buf_ = new float[BUF_MAX];
-
-    // Allocate memory for the Hanning window lookup table.
-    window_  = new float[BUF_MAX];
+TalkBoxProcessor::TalkBoxProcessor() : rec_(ORD_MAX - 1) {
+    // The OLA buffers live in the analyzer (modulator frames) and the
+    // synthesizer (carrier and vocoded frames), allocated and zeroed there.
 
     // Initialize state variables.
     // - K_ = 0: This is the toggle for the half-rate processing.
     N_ = 0;
     K_ = 0;              // Suggested by Gemini revision
-    
-    // Zero out all buffers to prevent processing garbage audio on the first pass.
-    memset(buf0_,0,sizeof(float)*BUF_MAX);      
-    memset(buf1_,0,sizeof(float)*BUF_MAX);
-    memset(car0_,0,sizeof(float)*BUF_MAX);
-    memset(car1_,0,sizeof(float)*BUF_MAX);
+
+    memset(rk_,0,sizeof(rk_));
+    memset(rz_,0,sizeof(rz_));
 }
 
 // Class destructor
-TalkBoxProcessor::~TalkBoxProcessor() {     
-    delete[] buf0_; delete[] car0_;
-    delete[] buf1_; delete[] car1_;
-    delete[] gender_buf_;
-    delete[] window_;
+TalkBoxProcessor::~TalkBoxProcessor() {
+    delete pipe_;
 }
 
 // Parameters update method
 void TalkBoxProcessor::updateParams(const TalkBoxParams& params) {
     // Compute LPC order order from quality slider
-    //      order_ = (0.0001 + 0.0004 * quality) * fs_
-    order_ = static_cast<int32_t>((0.0001f + 0.0004f * params.quality) * fs_);
-
-    // Clamp order_ to be less than ORD_MAX to prevent stack buffer overflows
-    // in the lpc() and lpc_durbin() functions, which use stack arrays of size ORD_MAX.
-    order_ = std::min(order_, ORD_MAX - 1);
+    //      order = (0.0001 + 0.0004 * quality) * fs_
+    // clamped to be less than ORD_MAX to prevent stack buffer overflows
+    // in the analysis, which uses stack arrays of size ORD_MAX.
+    // The analyzer re-evaluates its autocorrelation backend for the new order.
+    analyzer_.setOrder(talkbox_order(fs_, params.quality));
 
     // Compute wet/dry gains exactly as in the plugin
     wet_gain_ = 0.5f * params.wet * params.wet;
     dry_gain_ = 2.0f * params.dry * params.dry;
 
     // Update gender parameter value
-    gender_ = params.gender;
+    analyzer_.setGender(params.gender);
+}
+
+// Autocorrelation backend selection
+void TalkBoxProcessor::setAutocorrMethod(AutocorrMethod method) {
+    analyzer_.setAutocorrMethod(method);
+}
+
+void TalkBoxProcessor::setAnalysisMode(AnalysisMode mode, int32_t updateInterval) {
+    analysis_mode_   = mode;
+    update_interval_ = std::max(updateInterval, (int32_t)1);
+    update_count_    = 0;
+}
+
+void TalkBoxProcessor::setSynthesisMethod(SynthesisMethod method) {
+    synth_.setSynthesisMethod(method);
+}
+
+void TalkBoxProcessor::setReflectionMethod(ReflectionMethod method) {
+    analyzer_.setReflectionMethod(method);
+}
+
+void TalkBoxProcessor::setDenormalMode(DenormalMode mode) {
+    denormal_mode_ = mode;
+}
+
+void TalkBoxProcessor::setAdaptiveOrder(float minError) {
+    analyzer_.setAdaptiveOrder(minError);
+}
+
+void TalkBoxProcessor::setPipelinedAnalysis(bool enable) {
+    if (enable && !pipe_) pipe_ = new LpcAnalysisPipe();
+    pipelined_ = enable;
+    if (pipe_) pipe_->init(fs_);     // restart the frame sequence
 }
 
 // Class initialization method
@@ -65,306 +80,291 @@ void TalkBoxProcessor::init(float sampleRate, const TalkBoxParams& params) {
     fs_ = std::clamp(sampleRate, 8000.0f, 96000.0f);    
 
     // Compute window length N_ (in samples). This is the "analysis frame" size.
-    // The magic number 0.01633f corresponds to ~784 samples at 48kHz.
-    int32_t newN = static_cast<int32_t>(0.01633f * fs_);
-    N_ = std::min(newN, BUF_MAX);     // Ensure it doesn't exceed buffer size
-
-    // Compute Hanning window ONCE.
-    // (We removed the 'if (newN != N_)' check because this
-    // is init(), so we *always* want to calculate it.)
-    float dp    = TWO_PI / static_cast<float>(N_);
-    float phase = 0.0f;
-    for (int32_t i = 0; i < N_; ++i) {
-        window_[i] = 0.5f - 0.5f * std::cos(phase);
-        phase    += dp;
-    }
+    N_ = talkbox_frame_length(fs_);
+
+    // Both halves of the LPC compute their Hanning window for N_ and reset
+    // their OLA write pointers; the analyzer also sizes its FFT backend for
+    // any order up to ORD_MAX-1, so later changes of quality never need a re-init.
+    analyzer_.init(fs_);
+    synth_.init(fs_);
+    if (pipe_) pipe_->init(fs_);
+
+    // Recursive window with the same centre of mass as the N_-sample Hann
+    // frame (2/(1-alpha) = N_/2). The scale maps its total weight
+    // 1/(1-alpha)^2 onto the energy of a Hann-windowed frame (3/8 * N_),
+    // so Durbin produces the same gain G in both modes.
+    float beta = 4.0f / static_cast<float>(N_);
+    rec_.init(1.0f - beta);
+    rec_scale_    = 0.375f * static_cast<float>(N_) * beta * beta;
+    update_count_ = 0;
+    rG_ = 0.0f;
+    rorder_ = 0;
+    memset(rk_,0,sizeof(rk_));
+    memset(rz_,0,sizeof(rz_));
 
     // Update parameters according to the TakBoxParams struct
     updateParams(params);
 
-    // Reset OLA write pointers and processing state.
-    pos_      = 0;
-    emphasis_ = 0.0f;
+    // Reset processing state.
+    K_        = 0;
     FX_       = 0.0f;
 
     // Zero all pre-/de-emphasis all-pass filter states
-    d0_ = d1_ = d2_ = d3_ = d4_ = 0.0f;
-    u0_ = u1_ = u2_ = u3_ = u4_ = 0.0f;
+    prefilter_.reset();
+    postfilter_.reset();
+}
+
+// Snapshot layout: header (magic, frame length, flags), the processor's own
+// state, the components in a fixed order, then the pipe's frame if flagged.
+// Everything is copied as it is in memory, so a snapshot is only meant for
+// the machine (and build) that wrote it.
+void TalkBoxProcessor::writeState(StateWriter& w, uint32_t flags) const {
+    w.put(SNAPSHOT_MAGIC);
+    w.put(N_);
+    w.put(flags);
+
+    w.put(K_);
+    w.put(FX_);
+    prefilter_.saveState(w);
+    postfilter_.saveState(w);
+    analyzer_.saveState(w);
+    synth_.saveState(w);
+
+    rec_.saveState(w);
+    w.put(update_count_);
+    w.put(rG_);
+    w.put(rorder_);
+    w.put(rk_, ORD_MAX);
+    w.put(rz_, ORD_MAX);
+
+    if ((flags & SNAPSHOT_PIPELINED) && pipe_) pipe_->saveState(w);
+}
+
+// Size of a snapshot with these flags; a counting writer runs the same code
+size_t TalkBoxProcessor::snapshotBytes(uint32_t flags) const {
+    StateWriter w(nullptr, 0);
+    writeState(w, flags & ~SNAPSHOT_PIPELINED);
+    size_t bytes = w.size();
+    if (flags & SNAPSHOT_PIPELINED) bytes += LpcAnalysisPipe::stateBytes(N_);
+    return bytes;
+}
+
+size_t TalkBoxProcessor::snapshotSize() const {
+    return snapshotBytes(pipelined_ ? SNAPSHOT_PIPELINED : 0);
+}
+
+size_t TalkBoxProcessor::saveSnapshot(void* dst, size_t capacity) const {
+    if (!dst || capacity < snapshotSize()) return 0;
+    StateWriter w(dst, capacity);
+    writeState(w, pipelined_ ? SNAPSHOT_PIPELINED : 0);
+    return w.ok() ? w.size() : 0;
+}
+
+bool TalkBoxProcessor::restoreSnapshot(const void* src, size_t size) {
+    if (!src) return false;
+
+    // Check the header and the size before touching any state, so that
+    // every read below succeeds
+    StateReader r(src, size);
+    uint32_t magic = 0, flags = 0;
+    int32_t n = 0;
+    r.get(magic);
+    r.get(n);
+    r.get(flags);
+    if (!r.ok() || magic != SNAPSHOT_MAGIC || n != N_ || (flags & ~SNAPSHOT_PIPELINED)) return false;
+    if (size != snapshotBytes(flags)) return false;
+
+    r.get(K_);
+    r.get(FX_);
+    prefilter_.restoreState(r);
+    postfilter_.restoreState(r);
+    analyzer_.restoreState(r);
+    synth_.restoreState(r);
+
+    rec_.restoreState(r);
+    r.get(update_count_);
+    r.get(rG_);
+    r.get(rorder_);
+    r.get(rk_, ORD_MAX);
+    r.get(rz_, ORD_MAX);
+
+    // A pipelined engine picks up the frame in flight, or starts the pipe
+    // again if the snapshot has none; a synchronous one ignores it
+    if (pipelined_ && pipe_)
+    {
+        if (flags & SNAPSHOT_PIPELINED) pipe_->restoreState(r);
+        else                            pipe_->restart();
+    }
+    return true;
 }
 
 // Process a block of samples
+//
+// The block is processed in chunks of up to STAGE_BLOCK samples, and each
+// chunk goes through stages that run over the whole chunk:
+//   1. carrier pre-filter           (every sample)
+//   2. decimation                   (keep the samples where the half-rate toggle fires)
+//   3. pre-emphasis                 (decimated modulator)
+//   4. analysis: windowing + OLA    (decimated, split at the frame boundaries)
+//      or the Recursive analysis
+//   5. hold + post-filter + mix     (every sample)
+// The arithmetic is the same as the old one-sample-at-a-time loop, in the
+// same order, so the output is bit-exact with it.
 void TalkBoxProcessor::processBlock(const float* modIn, 
                                     const float* carIn,
                                     float* outL,
                                     float* outR,
                                     int32_t frames)     // block size
 {
-    // Accessing local variables is usually faster than accessing class 
-    // member variables repeatedly, so we create local copies of the state variables
-    int32_t p0      = pos_;
-    int32_t p1      = (pos_ + N_/2) % N_;      // 50% offset pointer
-    float   emph    = emphasis_;
-    float   fx      = FX_;
-
-    // Filter coefficients for the all-pass pre/post filters
-    const float h0  = 0.3f;
-    const float h1  = 0.77f;
-
-    // Main loop which processes 1 sample at a time
-    for (int32_t n = 0; n < frames; ++n)
+    // Denormals (very, very small floats near zero) appear wherever
+    // something decays into silence: the all-pass states, the lattice,
+    // the OLA buffers, a fading carrier. They can cripple the FPU, so the
+    // block runs with flush-to-zero/denormals-are-zero on; the caller's
+    // FPU mode is restored when 'guard' goes out of scope.
+    const bool flush = denormal_mode_ == DenormalMode::Flush && ScopedDenormalFlush::supported;
+    ScopedDenormalFlush guard(flush);
+
+    for (int32_t done = 0; done < frames; done += STAGE_BLOCK)
     {
-        // Read inputs (m and c are just single samples)
-        float m = modIn[n];       // modulator
-        float c = carIn[n];       // carrier
-        float dry = m;            // dry path copy
-
-        // Pre-filter the carrier
-        // This is a fixed filter (two 1st-order all-pass sections)
-        // that "smears" the phase. It's not part of LPC, but
-        // it thickens the carrier sound, making the result less "buzzy".
-        {
-            float p = d0_ + h0 * c;
-            d0_ = d1_;  d1_ = c - h0 * p;
-            float q = d2_ + h1 * d4_;
-            d2_ = d3_;  d3_ = d4_ - h1 * q;
-            d4_ = c;
-            c = p + q;    // c now holds the filtered carrier
-        }
-
-        // Half-Rate Processing: Run LPC every OTHER sample.
-        // The 'K_' variable toggles 0, 1, 0, 1...
-        if (K_++)
-        {
-            K_ = 0;           // reset toggle
-
-            // Capture the filtered carrier into both OLA buffers.
-            // p0 and p1 are the two 50%-offset write pointers.
-            car0_[p0] = car1_[p1] = c;
-
-            // Pre-emphasis on modulator (o).
-            // This is a simple high-pass filter: x = o(t) - o(t-1)
-            // It boosts high frequencies, which helps the LPC algorithm "see" high-frequency formants more clearly.
-            c = m - emph;
-            emph = m;
-
-            // Window & OLA for the *first* buffer (buf0_)
-            float w = window_[p0];
-
-            // Read "old" vocoded audio *out* of the buffer, fading it
-            // *out* with the window. This sample was written N_ samples ago.
-            fx = buf0_[p0] * w;
-
-            // Write the *new* pre-emphasized modulator *in*, fading it
-            // *in* with the window.
-            buf0_[p0] = c * w;
-
-            // Check if this buffer is full...
-            if (++p0 >= N_)
-            {   
-                // If yes, run the LPC analysis/synthesis.
-                // lpc() will:
-                //   1. ANALYZE 'buf0_' (modulator) to find filter coeffs.
-                //   2. SYNTHESIZE by filtering 'car0_' (carrier)
-                //   3. OVERWRITE 'buf0_' with the new vocoded audio.
-                // lpc(buf0_, car0_, N_, order_);
-                lpc_gender(buf0_, car0_, N_, order_, gender_);
-                p0 = 0;         // Wrap pointer
-            }
-
-            // Window & OLA for the *second* buffer (buf1_)
-            // This is identical, but uses the 50%-offset pointer 'p1' and a complementary window.
-            float w2 = 1.0f - w;
-
-            // Read "old" vocoded audio and *add* it to fx.
-            // This is the "overlap-add": we add the fading-out
-            // signal from buf1_ to the fading-out signal from buf0_.
-            fx += buf1_[p1] * w2;
-
-            // Write the *new* modulator in.
-            buf1_[p1] = c * w2;
-
-            // Check if this buffer is full...
-            if (++p1 >= N_)
-            {   
-                // As before, if yes run LPC analysis/synthesis.
-                // lpc(buf1_, car1_, N_, order_);
-                lpc_gender(buf1_, car1_, N_, order_, gender_);
-                p1 = 0;         // Wrap pointer
-            }
-        }
-
-        // Post-filter the combined LPC output (fx)
-        // This applies the *exact same* all-pass filter as in step 2.
-        // This is a common technique to "un-smear" the phase,
-        // though in this case it just adds more color.
-        {
-            float p = u0_ + h0 * fx;
-            u0_ = u1_;  u1_ = fx - h0 * p;
-            float q = u2_ + h1 * u4_;
-            u2_ = u3_;  u3_ = u4_ - h1 * q;
-            u4_ = fx;
-            c = p + q;    // 'c' is now the final WET (vocoded) signal
-        }
-
-        // Mix wet (vocoded) + dry (voice)
-        float out = wet_gain_ * c + dry_gain_ * dry;
-
-        // Write to stereo output buffers
-        outL[n] = out;
-        outR[n] = out;
+        int32_t n = std::min(STAGE_BLOCK, frames - done);
+        processChunk(modIn + done, carIn + done, outL + done, outR + done, n);
     }
 
-    // store state back to member variables
-    pos_       = p0;
-    emphasis_  = emph;
-    FX_        = fx;
-
-    // This code prevents "denormal" numbers (very, very small floats
-    // near zero) from crippling the FPU. If a filter state is
-    // effectively zero, just set it to 0.0f.
-    float den = 1.0e-10f;
-    if (std::abs(d0_) < den) d0_ = 0.0f;
-    if (std::abs(d1_) < den) d1_ = 0.0f;
-    if (std::abs(d2_) < den) d2_ = 0.0f;
-    if (std::abs(d3_) < den) d3_ = 0.0f;
-    // d4_ is an input snapshot, not a decaying state in the same way,
-    // but the original doesn't clear it.
-    // The original only clears d0_,d1_,d2_,d3_ and u0_,u1_,u2_,u3_.
-    if (std::abs(u0_) < den) u0_ = 0.0f;
-    if (std::abs(u1_) < den) u1_ = 0.0f;
-    if (std::abs(u2_) < den) u2_ = 0.0f;
-    if (std::abs(u3_) < den) u3_ = 0.0f;
+    // Without the hardware modes, fall back to the original guard: if a
+    // filter state is effectively zero, just set it to 0.0f.
+    if (!flush)
+    {
+        prefilter_.flushDenormals(1.0e-10f);
+        postfilter_.flushDenormals(1.0e-10f);
+    }
 }
 
-
-void TalkBoxProcessor::lpc(float* buf, float* car, int32_t n, int32_t o)
+void TalkBoxProcessor::processChunk(const float* modIn,
+                                    const float* carIn,
+                                    float* outL,
+                                    float* outR,
+                                    int32_t n)
 {
-    float z[ORD_MAX], r[ORD_MAX], k[ORD_MAX], G, x;
-    int32_t i, j, nn = n;
-
-    r[0] = 0.0f;  // ensure it's initialized just to avoid the warning when compiling
-    for (j = 0; j <= o; j++, nn--)  //buf[] is already emphasized and windowed
+    // 1. Pre-filter the carrier
+    // A fixed all-pass that "smears" the phase. It's not part of LPC, but
+    // it thickens the carrier sound, making the result less "buzzy".
+    prefilter_.process(carIn, stage_car_, n);
+
+    // 2. Half-Rate Processing: LPC runs on every OTHER sample.
+    // The toggle K_ fires on the samples where it was 1, so the first
+    // decimated sample of this chunk is index 0 if K_ == 1, else index 1.
+    int32_t first = K_ ? 0 : 1;
+    int32_t count = 0;
+    for (int32_t j = first; j < n; j += 2, count++)
     {
-        z[j] = r[j] = 0.0f;
-        for (i = 0; i < nn; i++) r[j] += buf[i] * buf[i + j]; //autocorrelation
+        dec_car_[count] = stage_car_[j];
+        dec_mod_[count] = modIn[j];
     }
-    r[0] *= 1.001f;  //stability fix
+    K_ = (K_ + n) & 1;
 
-    float min = 0.00001f;
-    if (r[0] < min) { for (i = 0; i < n; i++) buf[i] = 0.0f; return; }
+    // 3. Pre-emphasis on the decimated modulator: x = o(t) - o(t-1)
+    // It boosts high frequencies, which helps the LPC algorithm "see" high-frequency formants more clearly.
+    analyzer_.emphasize(dec_mod_, dec_emph_, count);
 
-    lpc_durbin(r, o, k, &G);  //calc reflection coeffs
+    // 4. Analysis/synthesis at the decimated rate: dec_fx_[] = LPC output
+    if (analysis_mode_ == AnalysisMode::Recursive) recursiveStage(count);
+    else                                           olaStage(count);
 
-    for (i = 0; i <= o; i++)
-    {
-        if (k[i] > 0.995f) k[i] = 0.995f; else if (k[i] < -0.995f) k[i] = -.995f;
-    }
+    // 5. Hold the LPC output over the skipped samples, post-filter and mix
+    if (first) stage_out_[0] = FX_;
+    for (int32_t j = first; j < n; j++) stage_out_[j] = dec_fx_[(j - first) >> 1];
+    FX_ = stage_out_[n - 1];
 
-    for (i = 0; i < n; i++)
+    // The post-filter is the *exact same* all-pass as the pre-filter,
+    // applied in place to the held LPC output.
+    postfilter_.process(stage_out_, stage_out_, n);
+
+    // Mix wet (vocoded) + dry (voice) and write to stereo output buffers
+    for (int32_t j = 0; j < n; j++)
     {
-        x = G * car[i];
-        for (j = o; j > 0; j--)     //lattice filter
-        {
-            x -= k[j] * z[j - 1];
-            z[j] = z[j - 1] + k[j] * x;
-        }
-        buf[i] = z[0] = x;  //output buf[] will be windowed elsewhere
+        float out = wet_gain_ * stage_out_[j] + dry_gain_ * modIn[j];
+        outL[j] = out;
+        outR[j] = out;
     }
 }
 
-// Same as lpc(), but with a 'gender' (formant) shift
-void TalkBoxProcessor::lpc_gender(float* buf, float* car, int32_t n, int32_t o, float gender_param)
+// Block mode: window & overlap-add of the decimated samples.
+// The analyzer and the synthesizer run the same frame schedule (two
+// 50%-offset write pointers), so the run is cut into segments that end
+// exactly where one of the frames is full. At the end of such a segment the
+// analyzer's coefficient record for the modulator frame drives the
+// synthesis of the carrier frame captured over the same samples; when
+// pipelined, the frame goes to the worker and the record of the previous
+// frame comes back instead.
+void TalkBoxProcessor::olaStage(int32_t count)
 {
-    float z[ORD_MAX], r[ORD_MAX], k[ORD_MAX], G, x;
-    int32_t i, j, nn = n;
-
-    // Resample Modulator for Formant Shifting 
-    float ratio = 1.0f + (-0.5f + gender_param);
+    int32_t i = 0;
 
-    if (std::abs(ratio - 1.0f) < 0.001f)
-    {
-        // Optimization: if gender is normal, just copy the buffer
-        memcpy(gender_buf_, buf, n * sizeof(float));
-    }
-    else
+    while (i < count)
     {
-        // Resample 'buf' into 'gender_buf_' using linear interpolation
-        float read_pos = 0.0f;
-        for (i = 0; i < n; i++)
+        int32_t len = std::min(count - i, analyzer_.samplesToFrame());
+
+        const float* frame = analyzer_.window(dec_emph_ + i, len);
+        synth_.process(dec_car_ + i, dec_fx_ + i, len);
+        if (frame)
         {
-            // Clamp read_pos to stay within bounds [0, n-1]
-            float clamped_pos = std::min(read_pos, (float)(n - 1));
-            
-            int32_t p0 = (int32_t)clamped_pos;
-            float frac = clamped_pos - p0;
-            
-            // Hold the last sample if we read past the end
-            int32_t p1 = std::min(p0 + (int32_t)1, n - (int32_t)1); 
-            
-            gender_buf_[i] = buf[p0] + frac * (buf[p1] - buf[p0]);
-            
-            read_pos += ratio;
+            if (pipelined_) pipe_->exchange(analyzer_, frame, frame_);
+            else            analyzer_.analyze(frame, frame_);
+            synth_.synthesize(frame_);
         }
-    }
 
-    r[0] = 0.0f;    // ensure it's initialized just to avoid the warning when compiling 
-    for (j = 0; j <= o; j++, nn--)
-    {
-        z[j] = r[j] = 0.0f;
-        // Use the resampled buffer instead of the original one:
-        for (i = 0; i < nn; i++) r[j] += gender_buf_[i] * gender_buf_[i + j]; //autocorrelation
+        i += len;
     }
-    r[0] *= 1.001f;     //stability fix
-    
-    float min = 0.00001f;
-    // On failure, clear the *original* output buffer
-    if (r[0] < min) { for (i = 0; i < n; i++) buf[i] = 0.0f; return; }
-
-    lpc_durbin(r, o, k, &G);    //calc reflection coeffs
+}
 
-    for (i = 0; i <= o; i++)
+// Recursive mode: feed the running autocorrelation and filter the
+// carrier one decimated sample at a time.
+void TalkBoxProcessor::recursiveStage(int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
     {
-        if (k[i] > 0.995f) k[i] = 0.995f; else if (k[i] < -0.995f) k[i] = -.995f;
-    }
+        rec_.push(dec_emph_[i]);
 
-    for (i = 0; i < n; i++)
-    {
-        x = G * car[i];
-        for (j = o; j > 0; j--)     //lattice filter
+        if (++update_count_ >= update_interval_)
         {
-            x -= k[j] * z[j - 1];
-            z[j] = z[j - 1] + k[j] * x;
+            update_count_ = 0;
+            updateRecursive();
         }
-        buf[i] = z[0] = x;  //output buf[] will be windowed elsewhere
+
+        dec_fx_[i] = latticeStep(dec_car_[i]);
     }
 }
 
 
-void TalkBoxProcessor::lpc_durbin(float* r, int32_t p, float* k, float* g)
+// Recursive mode: refresh the reflection coefficients from the running autocorrelation
+void TalkBoxProcessor::updateRecursive()
 {
-    int32_t i, j;
-    float a[ORD_MAX], at[ORD_MAX], e = r[0];
+    float r[ORD_MAX];
+    int32_t o = analyzer_.order();
 
-    for (i = 0; i <= p; i++) a[i] = at[i] = 0.0f; //probably don't need to clear at[] or k[]
+    rec_.read(r, o, rec_scale_);
+    analyzer_.coefficients(r, o, frame_);      // stability fix, silence check, recursion, clamp
 
-    for (i = 1; i <= p; i++)
-    {
-        k[i] = -r[i];
+    if (frame_.silent) { rG_ = 0.0f; return; }   // silence: mute the lattice input, let its state drain
 
-        for (j = 1; j < i; j++)
-        {
-            at[j] = a[j];
-            k[i] -= a[j] * r[i - j];
-        }
-        if (fabs(e) < 1.0e-20f) { e = 0.0f;  break; }
-        k[i] /= e;
+    int32_t used = frame_.order;
+    memcpy(rk_, frame_.k, (used + 1) * sizeof(float));
+    rG_ = frame_.G;
 
-        a[i] = k[i];
-        for (j = 1; j < i; j++) a[j] = at[j] + k[i] * at[i - j];
+    // Stages switched back on start from zero state
+    for (int32_t i = rorder_ + 1; i <= used; i++) rz_[i] = 0.0f;
+    rorder_ = used;
+}
 
-        e *= 1.0f - k[i] * k[i];
+// Recursive mode: one sample of the lattice filter, state kept in rz_[]
+float TalkBoxProcessor::latticeStep(float c)
+{
+    float x = rG_ * c;
+    for (int32_t j = rorder_; j > 0; j--)
+    {
+        x -= rk_[j] * rz_[j - 1];
+        rz_[j] = rz_[j - 1] + rk_[j] * x;
     }
-
-    if (e < 1.0e-20f) e = 0.0f;
-    *g = (float)sqrt(e);
-}
\ No newline at end of file
+    rz_[0] = x;
+    return x;
+}
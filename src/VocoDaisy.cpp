@@ -1,25 +1,30 @@
+#include <cassert>
 #include "daisy_seed.h"
 #include "daisysp.h"
-#include "TalkBoxProcessor.h"
+#include "StaticTalkBox.h"
 
 using namespace daisy;
 using namespace daisysp;
 
+// Audio path fixed at compile time: 48 kHz, 48-sample blocks.
+// The engine is instantiated for five LPC orders (quality 0, .25, .5, .75, 1).
+using AudioConfig = TalkBoxConfig<48000, 48>;
+
 DaisySeed hw;
-TalkBoxProcessor talkbox;
+StaticTalkBox<AudioConfig, 4, 9, 14, 19, 23> talkbox;
 
 // Optional: parameters struct for initialization
 TalkBoxParams params;
 
 void AudioCallback(AudioHandle::InputBuffer in, AudioHandle::OutputBuffer out, size_t size)
 {
-    // Process the block
+    // Process the block: StaticTalkBox only handles AudioConfig::blockSize samples
+    assert(size == AudioConfig::blockSize);
     talkbox.processBlock(
         in[0],      // modulator (voice)
         in[1],      // carrier
         out[0],     // left output
-        out[1],     // right output
-        size
+        out[1]      // right output
     );
 }
 
@@ -27,16 +32,14 @@ int main(void)
 {
     // Initialize Daisy Seed hardware
     hw.Init();
-    hw.SetAudioBlockSize(48); // block size
+    hw.SetAudioBlockSize(AudioConfig::blockSize); // block size
     hw.SetAudioSampleRate(SaiHandle::Config::SampleRate::SAI_48KHZ);
-	// Get actual sample rate after audio setup
-	float sample_rate = hw.AudioSampleRate();
 
-    // Initialize TalkBoxProcessor
+    // Initialize the talkbox (sample rate comes from AudioConfig)
     params.quality = 1.0f; 				// adjust as needed
     params.wet     = 1.0f; 				// full effect
     params.dry     = 0.0f; 				// ignore dry voice if desired
-    talkbox.init(sample_rate, params); 	// match hw sample rate
+    talkbox.init(params);
 
     // Start audio with callback
     hw.StartAudio(AudioCallback);
@@ -0,0 +1,222 @@
+#include "PolyphaseResampler.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+
+// Taps per output (at the output rate when downsampling) and the Kaiser
+// stopband attenuation in dB of each quality setting
+static constexpr int32_t RESAMPLE_TAPS[]  = { 16, 32, 64 };
+static constexpr double  RESAMPLE_ATTEN[] = { 60.0, 80.0, 100.0 };
+
+static constexpr double PI = 3.14159265358979323846;
+
+// Zeroth-order modified Bessel function (Kaiser window), power series
+static double bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int32_t k = 1; k < 50 && term > sum * 1e-17; k++)
+    {
+        double h = x / (2.0 * k);
+        term *= h * h;
+        sum  += term;
+    }
+    return sum;
+}
+
+// One output: taps-long dot product of the input window with a bank row.
+// n is a multiple of 8.
+static inline float resample_dot(const float* x, const float* c, int32_t n)
+{
+    int32_t i = 0;
+    float s;
+
+#if defined(TALKBOX_SIMD_AVX)
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16)
+    {
+    #if defined(TALKBOX_SIMD_FMA)
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i),     _mm256_loadu_ps(c + i),     a0);
+        a1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(c + i + 8), a1);
+    #else
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(x + i),     _mm256_loadu_ps(c + i)));
+        a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(c + i + 8)));
+    #endif
+    }
+    for (; i + 8 <= n; i += 8)
+        a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(c + i)));
+    s = simd_hsum(_mm256_add_ps(a0, a1));
+#elif defined(TALKBOX_SIMD_SSE)
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8)
+    {
+        a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(x + i),     _mm_loadu_ps(c + i)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(c + i + 4)));
+    }
+    s = simd_hsum(_mm_add_ps(a0, a1));
+#elif defined(TALKBOX_SIMD_NEON)
+    float32x4_t a0 = vdupq_n_f32(0.0f), a1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8)
+    {
+        a0 = vmlaq_f32(a0, vld1q_f32(x + i),     vld1q_f32(c + i));
+        a1 = vmlaq_f32(a1, vld1q_f32(x + i + 4), vld1q_f32(c + i + 4));
+    }
+    s = simd_hsum(vaddq_f32(a0, a1));
+#else
+    // Four partial sums, as the vector versions keep several accumulators
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (; i + 4 <= n; i += 4)
+    {
+        s0 += x[i]     * c[i];
+        s1 += x[i + 1] * c[i + 1];
+        s2 += x[i + 2] * c[i + 2];
+        s3 += x[i + 3] * c[i + 3];
+    }
+    s = (s0 + s1) + (s2 + s3);
+#endif
+
+    for (; i < n; i++) s += x[i] * c[i];
+    return s;
+}
+
+
+PolyphaseResampler::PolyphaseResampler(uint32_t inRate, uint32_t outRate, ResampleQuality quality)
+    : in_rate_(inRate), out_rate_(outRate)
+{
+    const int32_t q = static_cast<int32_t>(quality);
+    taps_ = RESAMPLE_TAPS[q];
+    if (inRate == 0 || outRate == 0) return;
+
+    uint32_t g = std::gcd(inRate, outRate);
+    if (outRate / g > static_cast<uint32_t>(MAX_PHASES) || inRate / g > (1u << 30)) return;
+    L_ = static_cast<int32_t>(outRate / g);
+    M_ = static_cast<int32_t>(inRate / g);
+
+    // Downsampling: the filter has to be longer in input samples for the
+    // same transition band relative to the (lower) output Nyquist
+    double down = std::max(1.0, static_cast<double>(M_) / L_);
+    taps_ = static_cast<int32_t>(std::ceil(taps_ * down / 8.0)) * 8;
+
+    // Kaiser design: transition width (radians per input sample) for this
+    // length and attenuation, placed just below the lower Nyquist
+    const double atten = RESAMPLE_ATTEN[q];
+    const double beta  = 0.1102 * (atten - 8.7);
+    const double width = (atten - 8.0) / (2.285 * (taps_ - 1));
+    const double cut   = 1.0 / down - 0.5 * width / PI;     // cutoff, fraction of the input Nyquist
+    const double half  = 0.5 * taps_;
+    const double i0b   = bessel_i0(beta);
+
+    bank_ = new float[L_ * taps_];
+    buf_  = new float[CHUNK + taps_];
+
+    // Row p, tap k: filter at t = p/L + taps/2 - 1 - k (distance from the
+    // output time to input sample floor(t) - taps/2 + 1 + k). Each row is
+    // normalized to unity DC gain.
+    for (int32_t p = 0; p < L_; p++)
+    {
+        float* row = bank_ + p * taps_;
+        double sum = 0.0;
+        for (int32_t k = 0; k < taps_; k++)
+        {
+            double t = static_cast<double>(p) / L_ + half - 1.0 - k;
+            double x = cut * t;
+            double sinc = (x == 0.0) ? 1.0 : std::sin(PI * x) / (PI * x);
+            double r = t / half;
+            double w = (r * r < 1.0) ? bessel_i0(beta * std::sqrt(1.0 - r * r)) / i0b : 0.0;
+            row[k] = static_cast<float>(cut * sinc * w);
+            sum   += cut * sinc * w;
+        }
+        for (int32_t k = 0; k < taps_; k++)
+            row[k] = static_cast<float>(row[k] / sum);
+    }
+
+    reset();
+}
+
+PolyphaseResampler::~PolyphaseResampler() {
+    delete[] bank_;
+    delete[] buf_;
+}
+
+void PolyphaseResampler::reset() {
+    if (!bank_) return;
+
+    // Zeros before the stream, so the first windows reach back past input 0
+    fill_ = taps_ / 2 - 1;
+    memset(buf_, 0, sizeof(float) * fill_);
+    base_     = -fill_;
+    pos_      = 0;
+    phase_    = 0;
+    in_count_ = 0;
+}
+
+int32_t PolyphaseResampler::maxOutput(int32_t count) const {
+    return static_cast<int32_t>(static_cast<int64_t>(count) * L_ / M_) + 1;
+}
+
+int32_t PolyphaseResampler::fill(const float* in, int32_t count) {
+    // Drop the inputs no future window reaches
+    int64_t drop = std::clamp<int64_t>(pos_ - taps_ / 2 + 1 - base_, 0, fill_);
+    if (drop > 0)
+    {
+        fill_ -= static_cast<int32_t>(drop);
+        memmove(buf_, buf_ + drop, sizeof(float) * fill_);
+        base_ += drop;
+    }
+
+    int32_t n = std::min(count, CHUNK + taps_ - fill_);
+    if (in) memcpy(buf_ + fill_, in, sizeof(float) * n);
+    else    memset(buf_ + fill_, 0, sizeof(float) * n);
+    fill_ += n;
+    return n;
+}
+
+int32_t PolyphaseResampler::run(float* out, int64_t end) {
+    const int32_t half  = taps_ / 2;
+    const int32_t step  = M_ / L_;          // input advance per output, whole samples
+    const int32_t frac  = M_ % L_;          // and fraction, in 1/L_
+    const int64_t avail = base_ + fill_;    // one past the last buffered input
+
+    int32_t n = 0;
+    while (pos_ + half < avail && pos_ < end)
+    {
+        const float* x = buf_ + (pos_ - half + 1 - base_);
+        out[n++] = resample_dot(x, bank_ + phase_ * taps_, taps_);
+
+        pos_   += step;
+        phase_ += frac;
+        if (phase_ >= L_) { phase_ -= L_; pos_++; }
+    }
+    return n;
+}
+
+int32_t PolyphaseResampler::process(const float* in, int32_t count, float* out) {
+    if (!bank_) return 0;
+
+    int32_t done = 0;
+    while (count > 0)
+    {
+        int32_t n = fill(in, count);
+        in += n;
+        count -= n;
+        in_count_ += n;
+        done += run(out + done, INT64_MAX);
+    }
+    return done;
+}
+
+int32_t PolyphaseResampler::flush(float* out) {
+    if (!bank_) return 0;
+
+    // Zeros after the stream for the last look-ahead; only outputs that
+    // fall inside the stream (t < in_count_) are produced
+    int32_t done = 0;
+    while (pos_ < in_count_)
+    {
+        fill(nullptr, taps_);
+        done += run(out + done, in_count_);
+    }
+    return done;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+
+
+// Filter length of the resampler against its cost. The figures are
+// relative to the lower of the two rates: when downsampling, the filter is
+// made in/out times longer and the passband is a fraction of the output Nyquist.
+enum class ResampleQuality {
+    Fast,       // 16 taps per output, ~60 dB alias rejection, passband to ~0.5 x Nyquist
+    Normal,     // 32 taps, ~80 dB, passband to ~0.7 x Nyquist
+    Best        // 64 taps, ~100 dB, passband to ~0.8 x Nyquist
+};
+
+
+// Streaming sample rate converter for a rational ratio out/in = L/M.
+//
+// Output sample n sits at input time t = n * M / L. Its value is the dot
+// product of the TAPS input samples around t with one row ("phase") of a
+// Kaiser-windowed sinc filter bank: row p holds the filter sampled at the
+// fraction p / L, so each of the L fractions the grid can hit has its
+// coefficients ready and the inner loop is a plain SIMD dot product. The
+// cutoff is set so the transition band ends at the lower of the two
+// Nyquist frequencies: nothing above it aliases back by more than the
+// rejection of the quality setting.
+//
+// The filter is centred on t, so output sample 0 lines up with input
+// sample 0 and no delay has to be compensated; in exchange an output needs
+// TAPS/2 inputs past its own time before process() can produce it, and
+// flush() delivers the last ones at the end of the stream. N inputs give
+// ceil(N * L / M) outputs in total, however the input was split into
+// blocks (the output does not depend on the block sizes).
+//
+// The rates are fixed in the constructor, which allocates the filter bank
+// (L * TAPS floats) and the input buffer; reset() and the processing never
+// allocate. Rates whose reduced L exceeds MAX_PHASES are not supported:
+// valid() is false and nothing is produced. Every pair of the usual rates
+// from 8 kHz to 192 kHz fits; the largest L among them is 2560, for
+// 11025 -> 192000 (a 640 KB bank at Best quality).
+class PolyphaseResampler {
+    public:
+        static constexpr int32_t MAX_PHASES = 4096;
+        static constexpr int32_t CHUNK      = 1024;     // inputs buffered per step
+
+        PolyphaseResampler(uint32_t inRate, uint32_t outRate, ResampleQuality quality = ResampleQuality::Normal);
+        ~PolyphaseResampler();
+
+        PolyphaseResampler(const PolyphaseResampler&) = delete;
+        PolyphaseResampler& operator=(const PolyphaseResampler&) = delete;
+
+        bool valid() const { return bank_ != nullptr; }
+
+        // Back to the start of a stream (empty history, output 0 at input 0)
+        void reset();
+
+        // Upper bound of the outputs process() or flush() write for 'count' inputs
+        int32_t maxOutput(int32_t count) const;
+
+        // Convert 'count' input samples; writes the outputs that are
+        // complete to 'out' (room for maxOutput(count)) and returns how many
+        int32_t process(const float* in, int32_t count, float* out);
+
+        // End of the stream: writes the outputs still waiting for their
+        // look-ahead (at most maxOutput(taps() / 2)) and returns how many.
+        // Call reset() before starting another stream.
+        int32_t flush(float* out);
+
+        uint32_t inRate()  const { return in_rate_; }
+        uint32_t outRate() const { return out_rate_; }
+        int32_t  taps()    const { return taps_; }
+        int32_t  phases()  const { return L_; }
+
+    private:
+        // Append up to 'count' inputs to the buffer, returns how many were taken
+        int32_t fill(const float* in, int32_t count);
+
+        // Produce the outputs the buffered input allows, up to input time 'end'
+        int32_t run(float* out, int64_t end);
+
+        uint32_t in_rate_, out_rate_;
+        int32_t L_ = 1, M_ = 1;         // out/in = L/M, reduced
+        int32_t taps_;
+        float* bank_ = nullptr;         // L_ rows of taps_ coefficients
+        float* buf_  = nullptr;         // input window, CHUNK + taps_ floats
+
+        int64_t base_ = 0;              // stream index of buf_[0]
+        int32_t fill_ = 0;              // valid floats in buf_
+        int64_t pos_ = 0;               // input index of the next output: floor(t)
+        int32_t phase_ = 0;             // and its fraction, in 1/L_
+        int64_t in_count_ = 0;          // inputs received since reset()
+};
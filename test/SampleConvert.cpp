@@ -0,0 +1,200 @@
+#include "SampleConvert.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+static constexpr float S16_SCALE = 32767.0f;
+static constexpr float S24_SCALE = 8388607.0f;
+
+// Clamp, scale and round one sample (round to nearest, as cvtps/vcvtn do).
+// Operand order as in to_int4(): max(-1, NaN) is -1, so NaN gives -full scale
+static inline int32_t to_int(float x, float scale)
+{
+    return static_cast<int32_t>(std::lrint(std::min(1.0f, std::max(-1.0f, x)) * scale));
+}
+
+static inline void put_s24(uint8_t* p, int32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+}
+
+#if defined(TALKBOX_SIMD_AVX) || defined(TALKBOX_SIMD_SSE)
+// Four samples clamped, scaled and rounded to int32 (maxps returns its
+// second operand when either is NaN, so NaN becomes -1)
+static inline __m128i to_int4(__m128 x, __m128 scale)
+{
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    return _mm_cvtps_epi32(_mm_mul_ps(x, scale));
+}
+#elif defined(TALKBOX_SIMD_NEON)
+static inline int32x4_t to_int4(float32x4_t x, float32x4_t scale)
+{
+    // vmaxq propagates NaN: turn it into -1 first, as the SSE path does
+    x = vbslq_f32(vceqq_f32(x, x), x, vdupq_n_f32(-1.0f));
+    x = vmulq_f32(vminq_f32(vmaxq_f32(x, vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f)), scale);
+#if defined(__aarch64__)
+    return vcvtnq_s32_f32(x);
+#else
+    // ARMv7 only truncates: add half away from zero first
+    uint32x4_t neg = vcltq_f32(x, vdupq_n_f32(0.0f));
+    return vcvtq_s32_f32(vaddq_f32(x, vbslq_f32(neg, vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f))));
+#endif
+}
+#endif
+
+
+void deinterleave_mix(const float* in, int32_t channels, const float* gains, float* mono, int64_t frames)
+{
+    int64_t i = 0;
+
+    if (channels == 1)
+    {
+        if (!gains) { memcpy(mono, in, sizeof(float) * frames); return; }
+        for (; i < frames; i++) mono[i] = gains[0] * in[i];
+        return;
+    }
+
+    if (channels == 2)
+    {
+        // No gains: a plain copy of the left channel (1 * L + 0 * R is not
+        // exact when R is inf or NaN)
+        const bool first = (gains == nullptr);
+        const float gl = first ? 1.0f : gains[0];
+        const float gr = first ? 0.0f : gains[1];
+
+#if defined(TALKBOX_SIMD_AVX)
+        const __m256 vl = _mm256_set1_ps(gl), vr = _mm256_set1_ps(gr);
+        for (; i + 8 <= frames; i += 8)
+        {
+            __m256 a  = _mm256_loadu_ps(in + 2 * i);          // L0 R0 .. L3 R3
+            __m256 b  = _mm256_loadu_ps(in + 2 * i + 8);      // L4 R4 .. L7 R7
+            __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);   // L0 R0 L1 R1 | L4 R4 L5 R5
+            __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);   // L2 R2 L3 R3 | L6 R6 L7 R7
+            __m256 l  = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+            if (first) { _mm256_storeu_ps(mono + i, l); continue; }
+            __m256 r  = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm256_storeu_ps(mono + i, _mm256_add_ps(_mm256_mul_ps(l, vl), _mm256_mul_ps(r, vr)));
+        }
+#elif defined(TALKBOX_SIMD_SSE)
+        const __m128 vl = _mm_set1_ps(gl), vr = _mm_set1_ps(gr);
+        for (; i + 4 <= frames; i += 4)
+        {
+            __m128 a = _mm_loadu_ps(in + 2 * i);              // L0 R0 L1 R1
+            __m128 b = _mm_loadu_ps(in + 2 * i + 4);          // L2 R2 L3 R3
+            __m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            if (first) { _mm_storeu_ps(mono + i, l); continue; }
+            __m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(mono + i, _mm_add_ps(_mm_mul_ps(l, vl), _mm_mul_ps(r, vr)));
+        }
+#elif defined(TALKBOX_SIMD_NEON)
+        for (; i + 4 <= frames; i += 4)
+        {
+            float32x4x2_t lr = vld2q_f32(in + 2 * i);          // de-interleaving load
+            if (first) { vst1q_f32(mono + i, lr.val[0]); continue; }
+            vst1q_f32(mono + i, vmlaq_n_f32(vmulq_n_f32(lr.val[0], gl), lr.val[1], gr));
+        }
+#endif
+        if (first) for (; i < frames; i++) mono[i] = in[2 * i];
+        else       for (; i < frames; i++) mono[i] = gl * in[2 * i] + gr * in[2 * i + 1];
+        return;
+    }
+
+    // Any other layout, scalar
+    if (!gains) {
+        for (; i < frames; i++) mono[i] = in[i * channels];
+        return;
+    }
+    for (; i < frames; i++)
+    {
+        const float* frame = in + i * channels;
+        float s = 0.0f;
+        for (int32_t c = 0; c < channels; c++) s += gains[c] * frame[c];
+        mono[i] = s;
+    }
+}
+
+void interleave_f32(const float* left, const float* right, float* out, int64_t frames)
+{
+    int64_t i = 0;
+#if defined(TALKBOX_SIMD_AVX) || defined(TALKBOX_SIMD_SSE)
+    for (; i + 4 <= frames; i += 4)
+    {
+        __m128 l = _mm_loadu_ps(left + i), r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(out + 2 * i,     _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+#elif defined(TALKBOX_SIMD_NEON)
+    for (; i + 4 <= frames; i += 4)
+    {
+        float32x4x2_t lr = { { vld1q_f32(left + i), vld1q_f32(right + i) } };
+        vst2q_f32(out + 2 * i, lr);
+    }
+#endif
+    for (; i < frames; i++) {
+        out[2 * i]     = left[i];
+        out[2 * i + 1] = right[i];
+    }
+}
+
+void interleave_s16(const float* left, const float* right, int16_t* out, int64_t frames)
+{
+    int64_t i = 0;
+#if defined(TALKBOX_SIMD_AVX) || defined(TALKBOX_SIMD_SSE)
+    const __m128 scale = _mm_set1_ps(S16_SCALE);
+    for (; i + 4 <= frames; i += 4)
+    {
+        __m128i l = to_int4(_mm_loadu_ps(left + i), scale);
+        __m128i r = to_int4(_mm_loadu_ps(right + i), scale);
+        __m128i lr = _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), lr);
+    }
+#elif defined(TALKBOX_SIMD_NEON)
+    const float32x4_t scale = vdupq_n_f32(S16_SCALE);
+    for (; i + 4 <= frames; i += 4)
+    {
+        int16x4x2_t lr = { { vqmovn_s32(to_int4(vld1q_f32(left + i), scale)),
+                             vqmovn_s32(to_int4(vld1q_f32(right + i), scale)) } };
+        vst2_s16(out + 2 * i, lr);
+    }
+#endif
+    for (; i < frames; i++) {
+        out[2 * i]     = static_cast<int16_t>(to_int(left[i], S16_SCALE));
+        out[2 * i + 1] = static_cast<int16_t>(to_int(right[i], S16_SCALE));
+    }
+}
+
+void interleave_s24(const float* left, const float* right, uint8_t* out, int64_t frames)
+{
+    int64_t i = 0;
+    // Conversion four frames at a time; the 3-byte packing has no cheap
+    // shuffle below SSSE3, so it stays a byte loop over the eight results
+#if defined(TALKBOX_SIMD_AVX) || defined(TALKBOX_SIMD_SSE)
+    const __m128 scale = _mm_set1_ps(S24_SCALE);
+    alignas(16) int32_t v[8];
+    for (; i + 4 <= frames; i += 4)
+    {
+        __m128i l = to_int4(_mm_loadu_ps(left + i), scale);
+        __m128i r = to_int4(_mm_loadu_ps(right + i), scale);
+        _mm_store_si128(reinterpret_cast<__m128i*>(v),     _mm_unpacklo_epi32(l, r));
+        _mm_store_si128(reinterpret_cast<__m128i*>(v + 4), _mm_unpackhi_epi32(l, r));
+        for (int32_t k = 0; k < 8; k++) put_s24(out + 6 * i + 3 * k, v[k]);
+    }
+#elif defined(TALKBOX_SIMD_NEON)
+    const float32x4_t scale = vdupq_n_f32(S24_SCALE);
+    alignas(16) int32_t v[8];
+    for (; i + 4 <= frames; i += 4)
+    {
+        int32x4x2_t lr = { { to_int4(vld1q_f32(left + i), scale), to_int4(vld1q_f32(right + i), scale) } };
+        vst2q_s32(v, lr);
+        for (int32_t k = 0; k < 8; k++) put_s24(out + 6 * i + 3 * k, v[k]);
+    }
+#endif
+    for (; i < frames; i++) {
+        put_s24(out + 6 * i,     to_int(left[i], S24_SCALE));
+        put_s24(out + 6 * i + 3, to_int(right[i], S24_SCALE));
+    }
+}
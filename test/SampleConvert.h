@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+
+// Sample layout kernels for file I/O: multichannel interleaved input folded
+// to the mono signal the engine takes, and the stereo output interleaved
+// and converted to the sample format of the file. Stereo, the common case,
+// has SIMD paths (shuffles for the deinterleave/interleave, conversion and
+// saturation four samples at a time); other channel counts run scalar.
+
+// How a multichannel input becomes mono
+enum class Downmix {
+    First,      // first channel only (the original behaviour)
+    Average,    // mean of all channels
+    Weighted    // one gain per channel
+};
+
+// Sample format of an output file
+enum class PcmFormat {
+    Float32,    // IEEE float, as written so far
+    Int16,
+    Int24       // packed, 3 bytes per sample
+};
+
+
+// Fold 'frames' interleaved frames of 'channels' channels to mono:
+//      mono[i] = sum_c gains[c] * in[i * channels + c]
+// With gains == nullptr the first channel is copied as is.
+void deinterleave_mix(const float* in, int32_t channels, const float* gains, float* mono, int64_t frames);
+
+// Interleave left/right into L R L R ... of the given format. The integer
+// formats clamp to [-1, 1] (NaN to -1), scale by 2^(bits-1) - 1 and round
+// to nearest; Int24 is little-endian, as in WAV files.
+void interleave_f32(const float* left, const float* right, float* out, int64_t frames);
+void interleave_s16(const float* left, const float* right, int16_t* out, int64_t frames);
+void interleave_s24(const float* left, const float* right, uint8_t* out, int64_t frames);
+
+// Bytes per sample of a format
+static inline int32_t pcm_bytes(PcmFormat format)
+{
+    return format == PcmFormat::Int16 ? 2 : (format == PcmFormat::Int24 ? 3 : 4);
+}
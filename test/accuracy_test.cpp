@@ -0,0 +1,244 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "TalkBoxFixed.h"
+#include "TalkBoxCore.h"
+
+// Accuracy of the optimized engines and kernels against a double-precision
+// reference (TalkBoxCore<double, double>):
+//   1. engine level: SNR of every engine/backend output against the
+//      reference output, and processing time
+//   2. kernel level: autocorrelation kernels against double r[], and the
+//      float recursions against double Durbin at the highest order
+//   3. the mda 1.001 stability fix: unstable frames with and without it,
+//      for float and double accumulation
+
+using RefCore   = TalkBoxCore<double, double>;
+using FloatCore = TalkBoxCore<float, float>;
+using MixedCore = TalkBoxCore<float, double>;
+
+static constexpr int BLOCK = 48;
+
+// SNR of 'x' with 'ref' as the signal
+static double snr(const std::vector<float>& x, const std::vector<double>& ref)
+{
+    double sig = 0.0, noise = 0.0;
+    for (size_t i = 0; i < ref.size(); i++)
+    {
+        double d = x[i] - ref[i];
+        sig   += ref[i] * ref[i];
+        noise += d * d;
+    }
+    return 10.0 * std::log10((sig + 1.0e-30) / (noise + 1.0e-30));
+}
+
+// Render a whole file through an engine, one block at a time; returns ms
+template <typename Engine, typename IO>
+static double render(Engine& engine, const std::vector<IO>& mod, const std::vector<IO>& car, std::vector<IO>& out)
+{
+    std::vector<IO> right(out.size());
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < mod.size(); pos += BLOCK) {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, mod.size() - pos));
+        engine.processBlock(mod.data() + pos, car.data() + pos, out.data() + pos, right.data() + pos, cur);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static void row(const std::string& name, double ms, double snrDb)
+{
+    std::cout << "  " << std::left << std::setw(34) << name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(9) << ms << " ms"
+              << std::setw(10) << snrDb << " dB\n" << std::defaultfloat;
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    float sampleRate = 0.0f;        // 0 = use the file rate
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) sampleRate = std::stof(argv[3]);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [engineSampleRate]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    uint64_t totalFrames = std::min(modFrames, carFrames);
+    mod.resize(totalFrames);
+    car.resize(totalFrames);
+    if (sampleRate <= 0.0f) sampleRate = static_cast<float>(modRate);
+
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+    const int32_t N = talkbox_frame_length(sampleRate);
+    const int32_t order = talkbox_order(sampleRate, params.quality);
+
+    std::cout << "Engine sample rate: " << sampleRate << " Hz, frame " << N << ", order " << order
+              << ", " << totalFrames << " frames\n\n";
+
+    // ---- 1. Engine level ------------------------------------------------
+
+    std::vector<double> modD(mod.begin(), mod.end()), carD(car.begin(), car.end());
+    std::vector<double> ref(totalFrames);
+    std::vector<float>  out(totalFrames);
+
+    RefCore reference;
+    reference.init(sampleRate, params);
+    double refMs = render(reference, modD, carD, ref);
+
+    std::cout << "Engines against the double reference (" << std::fixed << std::setprecision(1)
+              << refMs << std::defaultfloat << " ms):\n";
+
+    {
+        FloatCore e;
+        e.init(sampleRate, params);
+        double ms = render(e, mod, car, out);
+        row("TalkBoxCore<float, float>", ms, snr(out, ref));
+    }
+    {
+        MixedCore e;
+        e.init(sampleRate, params);
+        double ms = render(e, mod, car, out);
+        row("TalkBoxCore<float, double>", ms, snr(out, ref));
+    }
+
+    struct Variant { const char* name; void (*setup)(TalkBoxProcessor&); };
+    const Variant variants[] = {
+        { "TalkBoxProcessor (SIMD autocorr)", [](TalkBoxProcessor& e) { e.setAutocorrMethod(AutocorrMethod::Direct); } },
+        { "TalkBoxProcessor (FFT autocorr)",  [](TalkBoxProcessor& e) { e.setAutocorrMethod(AutocorrMethod::Fft); } },
+        { "TalkBoxProcessor (direct form)",   [](TalkBoxProcessor& e) { e.setSynthesisMethod(SynthesisMethod::DirectForm); } },
+        { "TalkBoxProcessor (Schur)",         [](TalkBoxProcessor& e) { e.setReflectionMethod(ReflectionMethod::Schur); } },
+    };
+    for (const Variant& v : variants)
+    {
+        TalkBoxProcessor e;
+        e.init(sampleRate, params);
+        v.setup(e);
+        double ms = render(e, mod, car, out);
+        row(v.name, ms, snr(out, ref));
+    }
+    {
+        TalkBoxFixed e;
+        e.init(sampleRate, params);
+        double ms = render(e, mod, car, out);
+        row("TalkBoxFixed", ms, snr(out, ref));
+    }
+
+    // ---- 2. Kernel level ------------------------------------------------
+
+    // Analysis frames as the engine builds them (decimated, pre-emphasized,
+    // Hann-windowed, hop N/2), in double and rounded to float
+    const int32_t maxLag = ORD_MAX - 1;
+    std::vector<double> x, window(N);
+    double emph = 0.0;
+    for (uint64_t i = 1; i < totalFrames; i += 2) { x.push_back(modD[i] - emph); emph = modD[i]; }
+    for (int32_t i = 0; i < N; i++) window[i] = 0.5 - 0.5 * std::cos(6.283185307179586 * i / N);
+
+    std::vector<double> frameD(N), rd(maxLag + 1), kd(ORD_MAX);
+    std::vector<float>  frameF(N), rf(maxLag + 1), kf(ORD_MAX);
+    FftAutocorrelator fft(BUF_MAX, maxLag);
+    fft.init(N, maxLag);
+
+    double errScalar = 0.0, errTiled = 0.0, errFft = 0.0, errMixed = 0.0;
+    double dkDurbin = 0.0, dkSchur = 0.0, dgDurbin = 0.0, dgSchur = 0.0;
+    int frames = 0;
+
+    auto relErr = [&](const float* r) {
+        double m = 0.0;
+        for (int32_t j = 0; j <= maxLag; j++) m = std::max(m, std::abs(r[j] - rd[j]) / rd[0]);
+        return m;
+    };
+
+    for (size_t s = 0; s + N <= x.size(); s += N / 2)
+    {
+        for (int32_t i = 0; i < N; i++) { frameD[i] = x[s + i] * window[i]; frameF[i] = static_cast<float>(frameD[i]); }
+
+        RefCore::autocorr(frameD.data(), N, maxLag, rd.data());
+        if (rd[0] < 0.00001) continue;      // silent, skipped by the engines too
+        frames++;
+
+        autocorr_scalar(frameF.data(), N, maxLag, rf.data());   errScalar = std::max(errScalar, relErr(rf.data()));
+        autocorr_tiled(frameF.data(), N, maxLag, rf.data());    errTiled  = std::max(errTiled,  relErr(rf.data()));
+        fft.compute(frameF.data(), N, maxLag, rf.data());       errFft    = std::max(errFft,    relErr(rf.data()));
+        {
+            std::vector<double> rm(maxLag + 1);
+            MixedCore::autocorr(frameF.data(), N, maxLag, rm.data());
+            for (int32_t j = 0; j <= maxLag; j++) rf[j] = static_cast<float>(rm[j]);
+            errMixed = std::max(errMixed, relErr(rf.data()));
+        }
+
+        // Recursions at the highest order, all from the same (fixed) r[]
+        double Gd;
+        rd[0] *= 1.001;
+        lpc_durbin(rd.data(), maxLag, kd.data(), &Gd);
+        for (int32_t j = 0; j <= maxLag; j++) rf[j] = static_cast<float>(rd[j]);
+
+        for (int method = 0; method < 2; method++)
+        {
+            float Gf;
+            if (method == 0) lpc_durbin(rf.data(), maxLag, kf.data(), &Gf);
+            else             lpc_schur(rf.data(), maxLag, kf.data(), &Gf);
+
+            double dk = 0.0;
+            for (int32_t j = 1; j <= maxLag; j++) dk = std::max(dk, std::abs(kf[j] - kd[j]));
+            double dg = std::abs(Gf - Gd) / std::max(Gd, 1.0e-30);
+            if (method == 0) { dkDurbin = std::max(dkDurbin, dk); dgDurbin = std::max(dgDurbin, dg); }
+            else             { dkSchur  = std::max(dkSchur,  dk); dgSchur  = std::max(dgSchur,  dg); }
+        }
+    }
+
+    std::cout << "\nKernels against double, " << frames << " frames, lags 0.." << maxLag << ":\n"
+              << std::scientific << std::setprecision(2)
+              << "  autocorr_scalar   max |r - r_ref| / r_ref[0] = " << errScalar << "\n"
+              << "  autocorr_tiled    max |r - r_ref| / r_ref[0] = " << errTiled  << "\n"
+              << "  FFT autocorr      max |r - r_ref| / r_ref[0] = " << errFft    << "\n"
+              << "  double-accum      max |r - r_ref| / r_ref[0] = " << errMixed  << "\n"
+              << "  lpc_durbin (order " << maxLag << ")  max |dk| = " << dkDurbin << ", max dG/G = " << dgDurbin << "\n"
+              << "  lpc_schur  (order " << maxLag << ")  max |dk| = " << dkSchur  << ", max dG/G = " << dgSchur  << "\n"
+              << std::defaultfloat;
+
+    // ---- 3. Stability fix -----------------------------------------------
+
+    std::cout << "\nStability fix r[0] *= 1.001 (unstable = some unclamped |k| >= 1):\n";
+    for (int withFix = 1; withFix >= 0; withFix--)
+    {
+        FloatCore f;  f.init(sampleRate, params);
+        MixedCore m;  m.init(sampleRate, params);
+        RefCore   d;  d.init(sampleRate, params);
+        if (!withFix) { f.setStabilityFix(1.0f); m.setStabilityFix(1.0); d.setStabilityFix(1.0); }
+
+        std::vector<double> outD(totalFrames);
+        double msF = render(f, mod, car, out);
+        double snrF = snr(out, ref);
+        double msM = render(m, mod, car, out);
+        double snrM = snr(out, ref);
+        render(d, modD, carD, outD);
+
+        std::cout << (withFix ? "  with 1.001:\n" : "  without:\n");
+        std::cout << "    float/float:   " << f.unstableFrames() << " unstable frames, "
+                  << std::fixed << std::setprecision(1) << snrF << " dB, " << msF << " ms\n"
+                  << "    float/double:  " << m.unstableFrames() << " unstable frames, "
+                  << snrM << " dB, " << msM << " ms\n"
+                  << "    double/double: " << d.unstableFrames() << " unstable frames\n"
+                  << std::defaultfloat;
+    }
+    return 0;
+}
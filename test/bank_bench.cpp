@@ -0,0 +1,186 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "TalkBoxCore.h"
+#include "TalkBoxBank.h"
+
+// Throughput of TalkBoxBank<Lanes> against one engine object per channel.
+//
+// CHANNELS vocal channels are built from the modulator/carrier pair, each
+// with its own time offset and parameters (wet, dry, quality, gender), and
+// rendered by:
+//   - one TalkBoxProcessor per channel (the current way to run a rack)
+//   - one TalkBoxCore<float, float> per channel (same arithmetic as the bank)
+//   - TalkBoxBank<4> and TalkBoxBank<8> covering all channels
+// For each: time, realtime factor per core (channel-seconds per second),
+// speed-up over the TalkBoxProcessor objects, and the largest difference
+// from the TalkBoxCore output. The banks run in both denormal modes: with
+// Clamp they must match the cores exactly, with the default Flush (hardware
+// FTZ vs the cores' state clamping) within TOLERANCE. Fails otherwise.
+
+static constexpr int   CHANNELS  = 8;
+static constexpr int   BLOCK     = 48;
+static constexpr float TOLERANCE = 1.0e-9f;     // max |diff| from TalkBoxCore, Flush mode
+
+struct Channel {
+    std::vector<float> mod, car, out, right;
+    TalkBoxParams params;
+};
+
+// Render every channel with one engine object each; returns ms
+template <typename Engine>
+static double renderEach(std::vector<Channel>& ch, float fs)
+{
+    std::vector<std::unique_ptr<Engine>> engines;
+    for (Channel& c : ch) { engines.emplace_back(new Engine()); engines.back()->init(fs, c.params); }
+
+    size_t total = ch[0].mod.size();
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (size_t c = 0; c < ch.size(); c++)
+            engines[c]->processBlock(ch[c].mod.data() + pos, ch[c].car.data() + pos,
+                                     ch[c].out.data() + pos, ch[c].right.data() + pos, cur);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// Render every channel with banks of Lanes channels; returns ms
+template <int32_t Lanes>
+static double renderBank(std::vector<Channel>& ch, float fs, DenormalMode denormals)
+{
+    static_assert(CHANNELS % Lanes == 0, "CHANNELS must be a multiple of the bank width");
+    constexpr int32_t BANKS = CHANNELS / Lanes;
+    std::vector<std::unique_ptr<TalkBoxBank<Lanes>>> banks;
+    for (int32_t b = 0; b < BANKS; b++)
+    {
+        banks.emplace_back(new TalkBoxBank<Lanes>());
+        banks.back()->setDenormalMode(denormals);
+        banks.back()->init(fs, ch[b * Lanes].params);
+        for (int32_t l = 0; l < Lanes; l++) banks.back()->updateParams(l, ch[b * Lanes + l].params);
+    }
+
+    const float* mod[Lanes]; const float* car[Lanes];
+    float* outL[Lanes]; float* outR[Lanes];
+    size_t total = ch[0].mod.size();
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (int32_t b = 0; b < BANKS; b++)
+        {
+            for (int32_t l = 0; l < Lanes; l++)
+            {
+                Channel& c = ch[b * Lanes + l];
+                mod[l] = c.mod.data() + pos;  car[l] = c.car.data() + pos;
+                outL[l] = c.out.data() + pos; outR[l] = c.right.data() + pos;
+            }
+            banks[b]->processBlock(mod, car, outL, outR, cur);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    float sampleRate = 0.0f;        // 0 = use the file rate
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) sampleRate = std::stof(argv[3]);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [engineSampleRate]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    uint64_t totalFrames = std::min(modFrames, carFrames);
+    if (sampleRate <= 0.0f) sampleRate = static_cast<float>(modRate);
+
+    // Channel c: signals rotated by a different offset, its own parameters
+    std::vector<Channel> ch(CHANNELS);
+    for (int c = 0; c < CHANNELS; c++)
+    {
+        ch[c].mod.resize(totalFrames);
+        ch[c].car.resize(totalFrames);
+        ch[c].out.resize(totalFrames);
+        ch[c].right.resize(totalFrames);
+        uint64_t shift = (totalFrames / CHANNELS) * c;
+        for (uint64_t i = 0; i < totalFrames; i++)
+        {
+            ch[c].mod[i] = mod[(i + shift) % totalFrames];
+            ch[c].car[i] = car[(i + 2 * shift) % totalFrames];
+        }
+        ch[c].params = TalkBoxParams{1.0f - 0.05f * c, 0.1f * (c % 3), 1.0f - 0.1f * (c % 4), (c % 2) ? 0.5f : 0.3f + 0.1f * c};
+    }
+
+    double audioSec = double(totalFrames) * CHANNELS / sampleRate;
+    std::cout << CHANNELS << " channels, " << totalFrames << " frames at " << sampleRate << " Hz, block "
+              << BLOCK << ", SIMD width " << TALKBOX_SIMD_WIDTH << "\n\n";
+
+    auto collect = [&]() {
+        std::vector<std::vector<float>> o;
+        for (Channel& c : ch) o.push_back(c.out);
+        return o;
+    };
+
+    double msCore = renderEach<TalkBoxCore<float>>(ch, sampleRate);
+    std::vector<std::vector<float>> ref = collect();
+    double msProc = renderEach<TalkBoxProcessor>(ch, sampleRate);
+
+    auto maxDiff = [&]() {
+        double m = 0.0;
+        for (int c = 0; c < CHANNELS; c++)
+            for (uint64_t i = 0; i < totalFrames; i++) m = std::max(m, double(std::abs(ch[c].out[i] - ref[c][i])));
+        return m;
+    };
+    double dProc = maxDiff();
+
+    double ms4 = renderBank<4>(ch, sampleRate, DenormalMode::Flush);
+    double d4 = maxDiff();
+    double ms8 = renderBank<8>(ch, sampleRate, DenormalMode::Flush);
+    double d8 = maxDiff();
+    double ms4c = renderBank<4>(ch, sampleRate, DenormalMode::Clamp);
+    double d4c = maxDiff();
+    double ms8c = renderBank<8>(ch, sampleRate, DenormalMode::Clamp);
+    double d8c = maxDiff();
+
+    auto row = [&](const char* name, double ms, double diff) {
+        std::cout << "  " << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << ms << " ms" << std::setw(9) << audioSec * 1000.0 / ms << "x realtime"
+                  << std::setw(7) << std::setprecision(2) << msProc / ms << "x"
+                  << std::scientific << std::setprecision(1) << std::setw(11) << diff << "\n" << std::defaultfloat;
+    };
+    std::cout << "  engine                              time     per core  speed-up  max |diff|\n";
+    row("TalkBoxProcessor x 8",     msProc, dProc);
+    row("TalkBoxCore<float> x 8",   msCore, 0.0);
+    row("TalkBoxBank<4> x 2",       ms4, d4);
+    row("TalkBoxBank<8> x 1",       ms8, d8);
+    row("TalkBoxBank<4> x 2, Clamp", ms4c, d4c);
+    row("TalkBoxBank<8> x 1, Clamp", ms8c, d8c);
+
+    bool ok = d4 <= TOLERANCE && d8 <= TOLERANCE && d4c == 0.0 && d8c == 0.0;
+    std::cout << "\n" << (ok ? "Banks match TalkBoxCore" : "FAILED: banks do not match TalkBoxCore")
+              << " (Clamp: exactly, Flush: within " << TOLERANCE << ")\n";
+    return ok ? 0 : 1;
+}
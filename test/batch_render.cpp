@@ -0,0 +1,199 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+
+// Batch render: many modulator/carrier pairs on a fixed-size thread pool.
+//
+// The manifest has one job per line:
+//
+//      <modulator.wav> <carrier.wav> <output.wav> [wet dry quality gender]
+//
+// (paths without spaces; the parameters default to 1 0 1 0.5 as in
+// main_test; blank lines and lines starting with '#' are skipped). Each
+// worker owns one engine and its buffers and takes the next job when it is
+// done with one, so the engine and buffers are reused from job to job and
+// only grow when a longer file comes along. init() clears all the
+// processing state, so every output is identical to rendering its pair
+// alone with main_test. A line with a malformed parameter is a manifest
+// error.
+//
+// Reports per job the audio length, the load / render / write times and its
+// realtime factor, then the aggregate realtime factor (audio seconds per
+// wall-clock second).
+
+struct Job {
+    std::string mod, car, out;
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+
+    // Filled in by the worker
+    bool ok = false;
+    double audio = 0.0;                 // seconds
+    double load = 0.0, render = 0.0, write = 0.0;
+};
+
+// One engine and its buffers, reused for every job of a worker
+struct Worker {
+    TalkBoxProcessor engine;
+    std::vector<float> mod, car, outL, outR, interleaved, scratch;
+};
+
+static bool readManifest(const char* path, std::vector<Job>& jobs) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Failed to open manifest: " << path << "\n";
+        return false;
+    }
+    std::string line;
+    for (int line_no = 1; std::getline(in, line); line_no++)
+    {
+        std::istringstream fields(line);
+        Job job;
+        if (!(fields >> job.mod) || job.mod[0] == '#') continue;
+        if (!(fields >> job.car >> job.out)) {
+            std::cerr << path << ":" << line_no << ": expected <modulator> <carrier> <output>\n";
+            return false;
+        }
+        // Either no parameters, or exactly four numbers
+        TalkBoxParams& p = job.params;
+        if (!(fields >> std::ws).eof())
+        {
+            std::string extra;
+            if (!(fields >> p.wet >> p.dry >> p.quality >> p.gender) || (fields >> extra)) {
+                std::cerr << path << ":" << line_no << ": expected wet dry quality gender\n";
+                return false;
+            }
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+static double since(std::chrono::steady_clock::time_point& t) {
+    auto now = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(now - t).count();
+    t = now;
+    return s;
+}
+
+static void runJob(Worker& w, Job& job, int32_t blockSize) {
+    auto t = std::chrono::steady_clock::now();
+
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(job.mod.c_str(), w.mod, modRate, modFrames, w.scratch)) return;
+    if (!loadWavToMono(job.car.c_str(), w.car, carRate, carFrames, w.scratch)) return;
+    if (modRate != carRate) {
+        std::cerr << job.mod << ", " << job.car << ": sample rates must match!\n";
+        return;
+    }
+    const uint64_t frames = std::min(modFrames, carFrames);
+    const float fs = static_cast<float>(modRate);
+    job.load = since(t);
+
+    // Same state as a new engine
+    w.engine.init(fs, job.params);
+
+    w.outL.resize(frames);
+    w.outR.resize(frames);
+    for (uint64_t pos = 0; pos < frames; pos += blockSize)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<uint64_t>(blockSize, frames - pos));
+        w.engine.processBlock(w.mod.data() + pos, w.car.data() + pos, w.outL.data() + pos, w.outR.data() + pos, cur);
+    }
+    job.render = since(t);
+
+    drwav_data_format fmt = {};
+    fmt.container     = drwav_container_riff;
+    fmt.format        = DR_WAVE_FORMAT_IEEE_FLOAT;
+    fmt.channels      = 2;
+    fmt.sampleRate    = modRate;
+    fmt.bitsPerSample = 32;
+
+    drwav outWav;
+    if (!drwav_init_file_write(&outWav, job.out.c_str(), &fmt, nullptr)) {
+        std::cerr << job.out << ": failed to open output WAV!\n";
+        return;
+    }
+    w.interleaved.resize(frames * 2);
+    for (uint64_t i = 0; i < frames; ++i) {
+        w.interleaved[2*i]   = w.outL[i];
+        w.interleaved[2*i+1] = w.outR[i];
+    }
+    uint64_t written = drwav_write_pcm_frames(&outWav, frames, w.interleaved.data());
+    drwav_uninit(&outWav);
+    job.write = since(t);
+
+    job.audio = frames / fs;
+    job.ok = (written == frames);
+}
+
+int main(int argc, char** argv) {
+
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <manifest.txt> [threads] [blockSize]\n"
+                  << "Manifest lines: <modulator.wav> <carrier.wav> <output.wav> [wet dry quality gender]\n";
+        return 1;
+    }
+    int32_t threads = (argc >= 3) ? std::stoi(argv[2]) : 0;
+    int32_t blockSize = (argc >= 4) ? std::max(std::stoi(argv[3]), 1) : 48;
+    if (threads <= 0) threads = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), (int32_t)1);
+
+    std::vector<Job> jobs;
+    if (!readManifest(argv[1], jobs)) return 1;
+    threads = std::min(threads, std::max(static_cast<int32_t>(jobs.size()), (int32_t)1));
+    std::cout << jobs.size() << " jobs on " << threads << " threads, block " << blockSize << "\n\n";
+
+    // Fixed pool: each worker takes the next job index until none are left
+    std::atomic<size_t> next{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int32_t t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&]() {
+            Worker w;
+            for (size_t j = next.fetch_add(1); j < jobs.size(); j = next.fetch_add(1))
+                runJob(w, jobs[j], blockSize);
+        });
+    }
+    for (std::thread& t : pool) t.join();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Per-job report, in manifest order
+    double audio = 0.0, busy = 0.0;
+    size_t failed = 0;
+    std::cout << "  job  audio s   load ms  render ms  write ms  realtime  output\n";
+    for (size_t j = 0; j < jobs.size(); j++)
+    {
+        const Job& job = jobs[j];
+        std::cout << "  " << std::setw(3) << j + 1;
+        if (!job.ok) {
+            std::cout << "  failed" << std::string(44, ' ') << job.out << "\n";
+            failed++;
+            continue;
+        }
+        double total = job.load + job.render + job.write;
+        audio += job.audio;
+        busy  += total;
+        std::cout << std::fixed << std::setprecision(1) << std::setw(9) << job.audio
+                  << std::setw(10) << job.load * 1e3 << std::setw(11) << job.render * 1e3
+                  << std::setw(10) << job.write * 1e3 << std::setw(10) << job.audio / total
+                  << "  " << job.out << "\n" << std::defaultfloat;
+    }
+
+    std::cout << "\n" << jobs.size() - failed << " jobs done";
+    if (failed) std::cout << ", " << failed << " failed";
+    std::cout << std::fixed << std::setprecision(1) << ": " << audio << " s of audio in " << std::setprecision(2) << wall << " s, realtime x" << std::setprecision(1)
+              << audio / wall << " (x" << (busy > 0.0 ? audio / busy : 0.0) << " per thread)\n";
+    return failed ? 1 : 0;
+}
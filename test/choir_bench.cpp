@@ -0,0 +1,204 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "TalkBoxCore.h"
+#include "ChoirTalkBox.h"
+
+// Cost of N voices sharing one carrier (ChoirTalkBox<N>) against one engine
+// object per voice, for N = 1, 2, 4, 8. Voice v is the modulator file at its
+// own time offset with its own parameters; all voices use the carrier file.
+// Reports for each:
+//   - time of N TalkBoxProcessor objects, and of the choir (per-voice outputs)
+//   - memory: object size + heap, counted by the operator new below
+//   - largest difference from N TalkBoxCore<float, float> (same arithmetic),
+//     with the default Flush mode and with DenormalMode::Clamp
+//   - largest difference between processBlockMixed() and the summed voices
+// Fails unless the Clamp choir matches the cores exactly, and the Flush
+// choir (hardware FTZ vs the cores' state clamping) and the mix are within
+// TOLERANCE.
+
+static constexpr int   BLOCK     = 48;
+static constexpr float TOLERANCE = 1.0e-9f;
+
+// Heap bytes allocated so far (kept out of line so the compiler does not
+// pair the inlined malloc/free with new/delete)
+static size_t heapBytes = 0;
+__attribute__((noinline)) void* operator new(size_t size) { heapBytes += size; if (void* p = std::malloc(size)) return p; throw std::bad_alloc(); }
+__attribute__((noinline)) void* operator new[](size_t size) { return operator new(size); }
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { operator delete(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { operator delete(p); }
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+struct Result { double msSep, msChoir, diff, clampDiff, mixDiff; size_t memSep, memChoir; };
+
+// N engine objects, one per voice; returns ms, fills 'out' and 'mem'
+template <typename Engine>
+static double renderEach(const std::vector<std::vector<float>>& mod, const std::vector<float>& car, int32_t N,
+                         float fs, const std::vector<TalkBoxParams>& params, std::vector<std::vector<float>>& out, size_t& mem)
+{
+    size_t total = car.size();
+    std::vector<float> right(total);
+    std::vector<Engine*> engines;
+    size_t before = heapBytes;
+    for (int32_t v = 0; v < N; v++) { engines.push_back(new Engine()); engines.back()->init(fs, params[v]); }
+    mem = heapBytes - before;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (int32_t v = 0; v < N; v++)
+            engines[v]->processBlock(mod[v].data() + pos, car.data() + pos, out[v].data() + pos, right.data() + pos, cur);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (Engine* e : engines) delete e;
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+template <int32_t N>
+static Result run(const std::vector<std::vector<float>>& mod, const std::vector<float>& car, float fs,
+                  const std::vector<TalkBoxParams>& params)
+{
+    size_t total = car.size();
+    Result res{};
+    std::vector<std::vector<float>> ref(N, std::vector<float>(total)), sep(N, std::vector<float>(total));
+    std::vector<std::vector<float>> outL(N, std::vector<float>(total)), outR(N, std::vector<float>(total));
+    size_t memCore;
+    renderEach<TalkBoxCore<float>>(mod, car, N, fs, params, ref, memCore);
+    res.msSep = renderEach<TalkBoxProcessor>(mod, car, N, fs, params, sep, res.memSep);
+
+    // One choir, per-voice outputs
+    size_t before = heapBytes;
+    ChoirTalkBox<N>* choir = new ChoirTalkBox<N>();
+    res.memChoir = heapBytes - before;
+    choir->init(fs, params[0]);
+    for (int32_t v = 0; v < N; v++) choir->updateParams(v, params[v]);
+
+    const float* m[N]; float* l[N]; float* r[N];
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (int32_t v = 0; v < N; v++) { m[v] = mod[v].data() + pos; l[v] = outL[v].data() + pos; r[v] = outR[v].data() + pos; }
+        choir->processBlock(m, car.data() + pos, l, r, cur);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    res.msChoir = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    for (int32_t v = 0; v < N; v++)
+        for (size_t i = 0; i < total; i++) res.diff = std::max(res.diff, double(std::abs(outL[v][i] - ref[v][i])));
+
+    // Same again with Clamp (a new object: init() does not clear the OLA buffers)
+    delete choir;
+    choir = new ChoirTalkBox<N>();
+    choir->setDenormalMode(DenormalMode::Clamp);
+    choir->init(fs, params[0]);
+    for (int32_t v = 0; v < N; v++) choir->updateParams(v, params[v]);
+    std::vector<std::vector<float>> clampL(N, std::vector<float>(total));
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (int32_t v = 0; v < N; v++) { m[v] = mod[v].data() + pos; l[v] = clampL[v].data() + pos; r[v] = outR[v].data() + pos; }
+        choir->processBlock(m, car.data() + pos, l, r, cur);
+    }
+    for (int32_t v = 0; v < N; v++)
+        for (size_t i = 0; i < total; i++) res.clampDiff = std::max(res.clampDiff, double(std::abs(clampL[v][i] - ref[v][i])));
+
+    // Mixed, Flush mode
+    delete choir;
+    choir = new ChoirTalkBox<N>();
+    std::vector<float> mixL(total), mixR(total);
+    choir->init(fs, params[0]);
+    for (int32_t v = 0; v < N; v++) choir->updateParams(v, params[v]);
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (int32_t v = 0; v < N; v++) m[v] = mod[v].data() + pos;
+        choir->processBlockMixed(m, car.data() + pos, mixL.data() + pos, mixR.data() + pos, cur);
+    }
+    for (size_t i = 0; i < total; i++)
+    {
+        float sum = 0.0f;
+        for (int32_t v = 0; v < N; v++) sum += outL[v][i];
+        res.mixDiff = std::max(res.mixDiff, double(std::abs(mixL[i] - sum)));
+    }
+    delete choir;
+    return res;
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    float sampleRate = 0.0f;        // 0 = use the file rate
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) sampleRate = std::stof(argv[3]);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [engineSampleRate]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    uint64_t totalFrames = std::min(modFrames, carFrames);
+    car.resize(totalFrames);
+    if (sampleRate <= 0.0f) sampleRate = static_cast<float>(modRate);
+
+    // Voice v: the modulator rotated by v/8 of its length, its own parameters
+    constexpr int32_t MAX_N = 8;
+    std::vector<std::vector<float>> mods(MAX_N, std::vector<float>(totalFrames));
+    std::vector<TalkBoxParams> params(MAX_N);
+    for (int32_t v = 0; v < MAX_N; v++)
+    {
+        for (uint64_t i = 0; i < totalFrames; i++) mods[v][i] = mod[(i + totalFrames * v / MAX_N) % totalFrames];
+        params[v] = TalkBoxParams{1.0f - 0.05f * v, 0.1f * (v % 3), 1.0f - 0.1f * (v % 4), (v % 2) ? 0.5f : 0.3f + 0.1f * v};
+    }
+
+    std::cout << totalFrames << " frames at " << sampleRate << " Hz, block " << BLOCK
+              << ", SIMD width " << TALKBOX_SIMD_WIDTH << "\n\n"
+              << "   N   separate (ms)   choir (ms)   speed-up   separate (KiB)   choir (KiB)   max |diff|  clamp |diff|   mix |diff|\n";
+
+    const int32_t Ns[] = {1, 2, 4, 8};
+    Result res[4];
+    res[0] = run<1>(mods, car, sampleRate, params);
+    res[1] = run<2>(mods, car, sampleRate, params);
+    res[2] = run<4>(mods, car, sampleRate, params);
+    res[3] = run<8>(mods, car, sampleRate, params);
+
+    bool ok = true;
+    for (int i = 0; i < 4; i++)
+    {
+        ok = ok && res[i].diff <= TOLERANCE && res[i].clampDiff == 0.0 && res[i].mixDiff <= TOLERANCE;
+        std::cout << std::setw(4) << Ns[i] << std::fixed << std::setprecision(1)
+                  << std::setw(16) << res[i].msSep << std::setw(13) << res[i].msChoir
+                  << std::setw(10) << std::setprecision(2) << res[i].msSep / res[i].msChoir << "x"
+                  << std::setprecision(1) << std::setw(17) << res[i].memSep / 1024.0
+                  << std::setw(14) << res[i].memChoir / 1024.0
+                  << std::scientific << std::setprecision(1) << std::setw(13) << res[i].diff
+                  << std::setw(14) << res[i].clampDiff << std::setw(13) << res[i].mixDiff
+                  << "\n" << std::defaultfloat;
+    }
+
+    std::cout << "\n" << (ok ? "Choir matches TalkBoxCore" : "FAILED: choir does not match TalkBoxCore")
+              << " (Clamp: exactly, Flush and mix: within " << TOLERANCE << ")\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "TalkBoxProcessor.h"
+
+// Per-block cost of a signal decaying into silence, with the hardware
+// flush-to-zero guard (DenormalMode::Flush) and with the original per-block
+// clamping of the all-pass states (DenormalMode::Clamp).
+//
+// The signals are synthetic so the decay is controlled: one second at full
+// level, then an exponential fade that crosses the float denormal range
+// (1.2e-38 .. 1.4e-45) and underflows to zero, then silence. Two scenarios:
+//   - carrier fade: the voice keeps talking, the carrier dies out, so the
+//     lattice, the OLA carrier buffers and the filters decay
+//   - full fade: voice and carrier both die out
+// The cost is the median over a few runs of each block's time, reported per
+// 250 ms segment. With Flush it should stay flat through the tail.
+
+static constexpr float FS         = 48000.0f;
+static constexpr int   BLOCK      = 48;
+static constexpr float FULL_SEC   = 1.0f;     // at full level
+static constexpr float FADE_SEC   = 3.0f;     // 0 dB down to -900 dB (float underflows to 0 at ~-897 dB)
+static constexpr float SILENT_SEC = 1.0f;
+static constexpr int   RUNS       = 5;
+static constexpr double PI        = 3.14159265358979323846;
+
+// Fade gain at sample i
+static float fadeGain(size_t i)
+{
+    const float start = FULL_SEC * FS;
+    if (i < start) return 1.0f;
+    float db = -900.0f * (i - start) / (FADE_SEC * FS);
+    return std::pow(10.0f, db / 20.0f);     // underflows to denormals, then 0
+}
+
+// Voice-like modulator (harmonics of 140 Hz with a falling spectrum and a
+// slow vowel sweep) and a sawtooth carrier at 110 Hz
+static void makeSignals(std::vector<float>& mod, std::vector<float>& car, bool fadeMod)
+{
+    size_t total = static_cast<size_t>((FULL_SEC + FADE_SEC + SILENT_SEC) * FS);
+    mod.assign(total, 0.0f);
+    car.assign(total, 0.0f);
+    double phase = 0.0, saw = 0.0;
+    for (size_t i = 0; i < total; i++)
+    {
+        double t = i / double(FS);
+        double f1 = 500.0 + 300.0 * std::sin(2.0 * PI * 0.7 * t);
+        double v = 0.0;
+        for (int h = 1; h <= 20; h++)
+        {
+            double f = 140.0 * h;
+            double formant = 1.0 / (1.0 + std::pow((f - f1) / 150.0, 2.0));
+            v += (0.3 / h + formant) * std::sin(h * phase);
+        }
+        phase += 2.0 * PI * 140.0 / FS;
+        saw += 110.0 / FS;
+        if (saw >= 1.0) saw -= 1.0;
+
+        float g = fadeGain(i);
+        mod[i] = static_cast<float>(0.1 * v) * (fadeMod ? g : 1.0f);
+        car[i] = static_cast<float>(0.5 * (2.0 * saw - 1.0)) * g;
+    }
+}
+
+// Time of every block (us), median over RUNS renders
+static std::vector<double> blockTimes(const std::vector<float>& mod, const std::vector<float>& car, DenormalMode mode)
+{
+    size_t blocks = mod.size() / BLOCK;
+    std::vector<std::vector<double>> runs(blocks);
+    std::vector<float> outL(BLOCK), outR(BLOCK);
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+
+    for (int r = 0; r < RUNS; r++)
+    {
+        TalkBoxProcessor engine;
+        engine.init(FS, params);
+        engine.setDenormalMode(mode);
+        for (size_t b = 0; b < blocks; b++)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            engine.processBlock(mod.data() + b * BLOCK, car.data() + b * BLOCK, outL.data(), outR.data(), BLOCK);
+            auto t1 = std::chrono::steady_clock::now();
+            runs[b].push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        }
+    }
+
+    std::vector<double> med(blocks);
+    for (size_t b = 0; b < blocks; b++)
+    {
+        std::sort(runs[b].begin(), runs[b].end());
+        med[b] = runs[b][RUNS / 2];
+    }
+    return med;
+}
+
+static void scenario(const char* name, bool fadeMod)
+{
+    std::vector<float> mod, car;
+    makeSignals(mod, car, fadeMod);
+    std::vector<double> clamp = blockTimes(mod, car, DenormalMode::Clamp);
+    std::vector<double> flush = blockTimes(mod, car, DenormalMode::Flush);
+
+    std::cout << name << "\n"
+              << "   time    level    Clamp mean/max (us)    Flush mean/max (us)\n";
+
+    const size_t seg = static_cast<size_t>(0.25f * FS) / BLOCK;
+    double steady[2] = {0.0, 0.0}, worst[2] = {0.0, 0.0};
+    for (size_t s = 0; s + seg <= clamp.size(); s += seg)
+    {
+        double mean[2] = {0.0, 0.0}, peak[2] = {0.0, 0.0};
+        for (size_t b = s; b < s + seg; b++)
+        {
+            mean[0] += clamp[b];  peak[0] = std::max(peak[0], clamp[b]);
+            mean[1] += flush[b];  peak[1] = std::max(peak[1], flush[b]);
+        }
+        mean[0] /= seg;
+        mean[1] /= seg;
+
+        float t = float(s * BLOCK) / FS;
+        if (t >= 0.25f && t < FULL_SEC) { steady[0] = std::max(steady[0], mean[0]); steady[1] = std::max(steady[1], mean[1]); }
+        if (t >= FULL_SEC)              { worst[0]  = std::max(worst[0],  mean[0]); worst[1]  = std::max(worst[1],  mean[1]); }
+
+        float g = fadeGain(s * BLOCK);
+        std::cout << std::fixed << std::setprecision(2) << std::setw(7) << t << " s "
+                  << std::setw(7);
+        if (g > 0.0f) std::cout << std::setprecision(0) << 20.0f * std::log10(g) << " dB";
+        else          std::cout << "-inf" << " dB";
+        std::cout << std::setprecision(2)
+                  << std::setw(13) << mean[0] << " / " << std::setw(6) << peak[0]
+                  << std::setw(16) << mean[1] << " / " << std::setw(6) << peak[1] << "\n";
+    }
+    std::cout << "  worst tail segment / steady state:  Clamp " << worst[0] / steady[0]
+              << "x,  Flush " << worst[1] / steady[1] << "x\n\n" << std::defaultfloat;
+}
+
+int main() {
+    std::cout << "Block " << BLOCK << " samples at " << FS << " Hz, median of " << RUNS << " runs, "
+              << "hardware flush " << (ScopedDenormalFlush::supported ? "available" : "NOT available (Flush = Clamp)")
+              << "\n\n";
+
+    scenario("Carrier fades into silence:", false);
+    scenario("Voice and carrier fade into silence:", true);
+
+    // The guard must hand the caller's FPU mode back untouched
+    volatile float tiny = 1.0e-38f;
+    volatile float half = 0.5f;
+    float d = tiny * half;
+    std::cout << "Caller FPU mode after processing: denormals "
+              << (d != 0.0f ? "preserved (restored)" : "flushed (NOT restored)") << "\n";
+    return d != 0.0f ? 0 : 1;
+}
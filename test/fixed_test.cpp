@@ -0,0 +1,100 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "TalkBoxFixed.h"
+
+// Compares the fixed-point engine against the float reference on the same
+// modulator/carrier pair and reports the SNR of the fixed-point output
+// (float output as the signal, the difference as the noise).
+
+// Render a whole file through an engine, one block at a time
+template <typename Engine>
+static double render(Engine& engine, const std::vector<float>& mod, const std::vector<float>& car,
+                     std::vector<float>& outL, std::vector<float>& outR, int blockSize)
+{
+    uint64_t totalFrames = mod.size();
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t pos = 0; pos < totalFrames; pos += blockSize) {
+        int curBlock = static_cast<int>(std::min<uint64_t>(blockSize, totalFrames - pos));
+        engine.processBlock(mod.data() + pos, car.data() + pos,
+                            outL.data() + pos, outR.data() + pos, curBlock);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    float sampleRate = 0.0f;        // 0 = use the file rate
+    int blockSize = 48;
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) sampleRate = std::stof(argv[3]);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [engineSampleRate]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    uint64_t totalFrames = std::min(modFrames, carFrames);
+    mod.resize(totalFrames);
+    car.resize(totalFrames);
+    if (sampleRate <= 0.0f) sampleRate = static_cast<float>(modRate);
+
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+
+    std::vector<float> refL(totalFrames), refR(totalFrames);
+    std::vector<float> fixL(totalFrames), fixR(totalFrames);
+
+    TalkBoxProcessor reference;
+    reference.init(sampleRate, params);
+    double refMs = render(reference, mod, car, refL, refR, blockSize);
+
+    TalkBoxFixed fixed;
+    fixed.init(sampleRate, params);
+    double fixMs = render(fixed, mod, car, fixL, fixR, blockSize);
+
+    // Overall SNR, and segmental SNR over 20 ms segments that are not silent
+    double sig = 0.0, noise = 0.0, segSum = 0.0;
+    int segCount = 0;
+    uint64_t segLen = static_cast<uint64_t>(0.02f * sampleRate);
+    for (uint64_t s = 0; s + segLen <= totalFrames; s += segLen) {
+        double ss = 0.0, sn = 0.0;
+        for (uint64_t i = s; i < s + segLen; ++i) {
+            double d = static_cast<double>(fixL[i]) - refL[i];
+            ss += static_cast<double>(refL[i]) * refL[i];
+            sn += d * d;
+        }
+        sig += ss;
+        noise += sn;
+        if (ss > segLen * 1.0e-6) {     // skip segments below -60 dBFS
+            segSum += 10.0 * std::log10((ss + 1.0e-20) / (sn + 1.0e-20));
+            segCount++;
+        }
+    }
+
+    double audioMs = 1000.0 * totalFrames / sampleRate;
+    std::cout << "Engine sample rate: " << sampleRate << " Hz, " << totalFrames << " frames\n";
+    std::cout << "Float engine:  " << refMs << " ms (" << audioMs / refMs << "x realtime)\n";
+    std::cout << "Fixed engine:  " << fixMs << " ms (" << audioMs / fixMs << "x realtime)\n";
+    std::cout << "SNR fixed vs float:      " << 10.0 * std::log10((sig + 1.0e-20) / (noise + 1.0e-20)) << " dB\n";
+    std::cout << "Segmental SNR (20 ms):   " << (segCount ? segSum / segCount : 0.0) << " dB over "
+              << segCount << " segments\n";
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+
+// Benchmarks lpc_durbin() against lpc_schur() for orders 8..49 on the
+// analysis frames of a real modulator, and cross-checks that both give the
+// same clamped reflection coefficients and gain. Then times the two
+// autocorrelation backends at the frame length of each standard sample
+// rate and the highest order it reaches, which is why the engine has no
+// automatic FFT selection: the direct kernel wins everywhere.
+
+// Tolerances of the cross-check. The two recursions round differently, and
+// the difference grows with the order and with how close |k| gets to 1.
+static constexpr float K_TOL = 1.0e-3f;     // absolute, on clamped k[]
+static constexpr float G_TOL = 1.0e-3f;     // relative, on G
+
+static void clampK(float* k, int32_t p)
+{
+    for (int32_t i = 0; i <= p; i++)
+    {
+        if (k[i] > 0.995f) k[i] = 0.995f; else if (k[i] < -0.995f) k[i] = -.995f;
+    }
+}
+
+// Time 'reps' passes of one recursion over all frames, in ns per call
+template <typename Fn>
+static double timeRecursion(Fn fn, const std::vector<std::vector<float>>& frames, int32_t p, int reps)
+{
+    float k[ORD_MAX], G, sink = 0.0f;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < reps; rep++)
+    {
+        for (const auto& r : frames)
+        {
+            fn(r.data(), p, k, &G);
+            sink += G;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    if (sink == 12345.0f) std::cout << "";      // keep the calls alive
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double(reps) * frames.size());
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    if (argc >= 2) {
+        modPath = argv[1];
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav>\n";
+        std::cout << "No arguments provided - using " << modPath << "\n";
+    }
+
+    std::vector<float> mod;
+    unsigned int rate;
+    uint64_t totalFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, rate, totalFrames)) return 1;
+
+    // Analysis frames as the engine sees them: decimated by 2, pre-emphasized,
+    // Hann-windowed, hop N/2. Silent frames are skipped like in lpc().
+    const float fs = static_cast<float>(rate);
+    const int32_t N = talkbox_frame_length(fs);
+    const int32_t maxOrder = ORD_MAX - 1;
+
+    std::vector<float> x, window(N), frame(N);
+    float emph = 0.0f;
+    for (uint64_t i = 1; i < totalFrames; i += 2) { x.push_back(mod[i] - emph); emph = mod[i]; }
+    for (int32_t i = 0; i < N; i++) window[i] = 0.5f - 0.5f * std::cos(TWO_PI * i / N);
+
+    std::vector<std::vector<float>> frames;
+    for (size_t s = 0; s + N <= x.size(); s += N / 2)
+    {
+        for (int32_t i = 0; i < N; i++) frame[i] = x[s + i] * window[i];
+        std::vector<float> r(maxOrder + 1);
+        autocorr(frame.data(), N, maxOrder, r.data());
+        r[0] *= 1.001f;
+        if (r[0] >= 0.00001f) frames.push_back(r);
+    }
+    if (frames.empty()) { std::cout << "No non-silent frames in " << modPath << "\n"; return 1; }
+
+    std::cout << frames.size() << " frames of " << N << " samples\n\n";
+    std::cout << "order   durbin ns   schur ns   speedup   max|dk|     max dG/G    mismatches\n";
+
+    int failures = 0;
+    for (int32_t p = 8; p <= maxOrder; p++)
+    {
+        // Cross-check on every frame
+        float maxDk = 0.0f, maxDg = 0.0f;
+        int bad = 0;
+        for (const auto& r : frames)
+        {
+            float kd[ORD_MAX], ks[ORD_MAX], Gd, Gs;
+            lpc_durbin(r.data(), p, kd, &Gd);
+            lpc_schur(r.data(), p, ks, &Gs);
+            clampK(kd, p);
+            clampK(ks, p);
+
+            float dk = 0.0f;
+            for (int32_t i = 1; i <= p; i++) dk = std::max(dk, std::abs(kd[i] - ks[i]));
+            float dg = std::abs(Gd - Gs) / std::max(Gd, 1.0e-30f);
+            maxDk = std::max(maxDk, dk);
+            maxDg = std::max(maxDg, dg);
+            if (dk > K_TOL || dg > G_TOL) bad++;
+        }
+        failures += bad;
+
+        int reps = std::max(1, 200000 / static_cast<int>(frames.size() * p));
+        double tD = timeRecursion([](const float* r, int32_t o, float* k, float* g) { lpc_durbin(r, o, k, g); },
+                                  frames, p, reps);
+        double tS = timeRecursion([](const float* r, int32_t o, float* k, float* g) { lpc_schur(r, o, k, g); },
+                                  frames, p, reps);
+
+        std::cout << std::setw(5) << p
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << tD << std::setw(11) << tS
+                  << std::setprecision(2) << std::setw(10) << tD / tS
+                  << std::scientific << std::setprecision(2)
+                  << std::setw(12) << maxDk << std::setw(12) << maxDg
+                  << std::setw(10) << bad << "\n" << std::defaultfloat;
+    }
+
+    // Autocorrelation backends, on the first frames of the file
+    std::cout << "\nrate     frame  order   direct ns     fft ns   fft/direct\n";
+    FftAutocorrelator fftAc(BUF_MAX, ORD_MAX - 1);
+    for (float rate : {8000.0f, 16000.0f, 22050.0f, 32000.0f, 44100.0f, 48000.0f, 88200.0f, 96000.0f})
+    {
+        const int32_t n = talkbox_frame_length(rate);
+        const int32_t p = talkbox_order(rate, 1.0f);
+        if (x.size() < static_cast<size_t>(n)) continue;
+        fftAc.init(n, ORD_MAX - 1);
+
+        float r[ORD_MAX], sink = 0.0f;
+        const int reps = std::max(1, 20000000 / (n * (p + 1)));
+        auto time = [&](auto fn) {
+            auto t0 = std::chrono::steady_clock::now();
+            for (int rep = 0; rep < reps; rep++) { fn(x.data(), n, p, r); sink += r[0]; }
+            auto t1 = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::nano>(t1 - t0).count() / reps;
+        };
+        double tDirect = time([](const float* v, int32_t len, int32_t lag, float* out) { autocorr(v, len, lag, out); });
+        double tFft    = time([&](const float* v, int32_t len, int32_t lag, float* out) { fftAc.compute(v, len, lag, out); });
+        if (sink == 12345.0f) std::cout << "";      // keep the calls alive
+
+        std::cout << std::setw(6) << static_cast<int>(rate) << std::setw(8) << n << std::setw(7) << p
+                  << std::fixed << std::setprecision(1) << std::setw(12) << tDirect << std::setw(11) << tFft
+                  << std::setprecision(2) << std::setw(11) << tFft / tDirect << "\n" << std::defaultfloat;
+    }
+
+    std::cout << "\nCross-check (|dk| <= " << K_TOL << ", dG/G <= " << G_TOL << "): "
+              << (failures ? "FAILED" : "passed") << "\n";
+    return failures ? 1 : 0;
+}
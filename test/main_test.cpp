@@ -3,53 +3,449 @@
 #include <cstdint>
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <thread>
 
-#define DR_WAV_IMPLEMENTATION
-#include "dr_wav.h"
+#include "wav_utils.h"
 #include "TalkBoxProcessor.h"
+#include "SpscQueue.h"
+#include "PolyphaseResampler.h"
 
-// Load WAV to mono float
-bool loadWavToMono(const char* path, std::vector<float>& monoData, unsigned int& sampleRate, uint64_t& totalFrames) {
-    drwav wav;
-    if (!drwav_init_file(&wav, path, nullptr)) {
-        std::cerr << "Failed to open WAV file: " << path << std::endl;
+// Frames read, processed and written per step in streaming mode
+static constexpr uint64_t STREAM_CHUNK = 4096;
+
+static void printStats(const TalkBoxProcessor& engine) {
+    const LpcOrderStats& stats = engine.orderStats();
+    std::cout << "LPC frames: " << stats.frames << " (+" << stats.silent << " silent), order used: mean "
+              << stats.meanOrder() << ", min " << (stats.frames ? stats.minOrder : 0)
+              << ", max " << stats.maxOrder << "\n";
+}
+
+// Input and output settings of a render. Rates: 0 means the rate of the
+// modulator file.
+struct RenderOptions {
+    uint32_t engine = 0;
+    uint32_t output = 0;
+    ResampleQuality quality = ResampleQuality::Normal;
+    WavDownmix downmix;                         // multichannel inputs to mono
+    PcmFormat format = PcmFormat::Float32;      // output file
+};
+
+static const char* qualityName(ResampleQuality q) {
+    switch (q) {
+        case ResampleQuality::Fast:   return "fast";
+        case ResampleQuality::Normal: return "normal";
+        default:                      return "best";
+    }
+}
+
+// A streaming input at the engine rate. When the file has another rate its
+// chunks go through a PolyphaseResampler into a small queue of converted
+// samples, so next() can still hand out whole chunks; otherwise the reader
+// is passed through (and WavMappedReader stays zero-copy).
+template <typename Reader>
+class EngineInput {
+    public:
+        bool open(const std::string& path, const WavDownmix& mix) {
+            reader_.setDownmix(mix);
+            return reader_.open(path.c_str());
+        }
+
+        unsigned int fileRate() const { return reader_.sampleRate(); }
+        bool resampled() const { return rs_ != nullptr; }
+
+        // Convert to 'engineRate' from here on; false if the resampler
+        // does not support the pair
+        bool setEngineRate(uint32_t engineRate, ResampleQuality quality) {
+            if (engineRate == fileRate()) return true;
+            rs_.reset(new PolyphaseResampler(fileRate(), engineRate, quality));
+            in_.resize(STREAM_CHUNK);
+            queue_.resize(STREAM_CHUNK + rs_->maxOutput(STREAM_CHUNK) + rs_->maxOutput(rs_->taps()));
+            return rs_->valid();
+        }
+
+        // Same contract as the readers: up to 'frames' (<= STREAM_CHUNK)
+        // samples, fewer only at the end
+        const float* next(uint64_t frames, float* buffer, uint64_t& got) {
+            if (!rs_) return reader_.next(frames, buffer, got);
+
+            // Keep the unread samples at the front, then convert input
+            // chunks until there are enough
+            size_ -= head_;
+            memmove(queue_.data(), queue_.data() + head_, size_ * sizeof(float));
+            head_ = 0;
+            while (size_ < frames && !ended_)
+            {
+                uint64_t n;
+                const float* in = reader_.next(STREAM_CHUNK, in_.data(), n);
+                size_ += rs_->process(in, static_cast<int32_t>(n), queue_.data() + size_);
+                if (n < STREAM_CHUNK) {
+                    size_ += rs_->flush(queue_.data() + size_);
+                    ended_ = true;
+                }
+            }
+            got = std::min<uint64_t>(frames, size_);
+            head_ = got;
+            return queue_.data();
+        }
+
+        // next() into 'dst'
+        uint64_t read(float* dst, uint64_t frames) {
+            uint64_t got;
+            const float* src = next(frames, dst, got);
+            if (src != dst) memcpy(dst, src, got * sizeof(float));
+            return got;
+        }
+
+    private:
+        Reader reader_;
+        std::unique_ptr<PolyphaseResampler> rs_;
+        std::vector<float> in_, queue_;
+        uint64_t head_ = 0, size_ = 0;      // unread samples: queue_[head_, size_)
+        bool ended_ = false;
+};
+
+// The streaming writer, converting from the engine rate to the output rate
+// when they differ. close() writes the tail still in the resamplers.
+class EngineOutput {
+    public:
+        bool open(const std::string& path, uint32_t engineRate, uint32_t outputRate, ResampleQuality quality,
+                  PcmFormat format) {
+            if (outputRate != engineRate)
+            {
+                left_.reset(new PolyphaseResampler(engineRate, outputRate, quality));
+                right_.reset(new PolyphaseResampler(engineRate, outputRate, quality));
+                if (!left_->valid()) {
+                    std::cerr << "Cannot resample " << engineRate << " Hz to " << outputRate << " Hz\n";
+                    return false;
+                }
+                bufL_.resize(left_->maxOutput(STREAM_CHUNK) + left_->maxOutput(left_->taps()));
+                bufR_.resize(bufL_.size());
+            }
+            return wav_.open(path.c_str(), outputRate, format);
+        }
+
+        // Write 'frames' (<= STREAM_CHUNK) engine-rate samples of each channel;
+        // false on a write error
+        bool write(const float* left, const float* right, uint64_t frames) {
+            if (!left_) return put(left, right, frames);
+            int32_t n = left_->process(left, static_cast<int32_t>(frames), bufL_.data());
+            right_->process(right, static_cast<int32_t>(frames), bufR_.data());
+            return put(bufL_.data(), bufR_.data(), n);
+        }
+
+        bool close() {
+            bool ok = true;
+            if (left_) {
+                int32_t n = left_->flush(bufL_.data());
+                right_->flush(bufR_.data());
+                ok = put(bufL_.data(), bufR_.data(), n);
+            }
+            wav_.close();
+            return ok;
+        }
+
+        bool resampled() const { return left_ != nullptr; }
+        uint64_t framesWritten() const { return written_; }
+
+    private:
+        bool put(const float* left, const float* right, uint64_t frames) {
+            uint64_t n = wav_.write(left, right, frames);
+            written_ += n;
+            return n == frames;
+        }
+
+        WavStereoWriter wav_;
+        std::unique_ptr<PolyphaseResampler> left_, right_;
+        std::vector<float> bufL_, bufR_;
+        uint64_t written_ = 0;
+};
+
+// Open both inputs and the output of a streaming render, with resamplers
+// wherever a rate differs from the engine rate, and report what runs where
+template <typename Reader>
+static bool openStreams(EngineInput<Reader>& mod, EngineInput<Reader>& car, EngineOutput& out,
+                        const std::string& modPath, const std::string& carPath, const std::string& outPath,
+                        RenderOptions& opts, const char* mode)
+{
+    if (!mod.open(modPath, opts.downmix) || !car.open(carPath, opts.downmix)) return false;
+    if (opts.engine == 0) opts.engine = mod.fileRate();
+    if (opts.output == 0) opts.output = opts.engine;
+
+    if (!mod.setEngineRate(opts.engine, opts.quality) || !car.setEngineRate(opts.engine, opts.quality)) {
+        std::cerr << "Cannot resample to " << opts.engine << " Hz\n";
         return false;
     }
+    if (!out.open(outPath, opts.engine, opts.output, opts.quality, opts.format)) return false;
+
+    std::cout << "Sample rate: " << opts.engine << " Hz (" << mode << ")\n";
+    auto note = [&](const char* what, uint32_t from, uint32_t to) {
+        std::cout << "  " << what << from << " Hz -> " << to << " Hz\n";
+    };
+    if (mod.resampled()) note("modulator: ", mod.fileRate(), opts.engine);
+    if (car.resampled()) note("carrier:   ", car.fileRate(), opts.engine);
+    if (out.resampled()) note("output:    ", opts.engine, opts.output);
+    if (mod.resampled() || car.resampled() || out.resampled())
+        std::cout << "  resampler quality: " << qualityName(opts.quality) << "\n";
+    return true;
+}
 
-    sampleRate = wav.sampleRate;
-    totalFrames = wav.totalPCMFrameCount;
-    unsigned int channels = wav.channels;
+// Streaming mode: modulator and carrier are read STREAM_CHUNK frames at a
+// time, processed, and each chunk is written out before the next is read.
+// Memory stays at a few chunk-sized buffers whatever the file length.
+// Reader is WavMonoReader ("stream": dr_wav file reads) or WavMappedReader
+// ("mmap": mono float files are processed straight from the mapping).
+// Inputs at another rate than the engine, and the output if asked for,
+// are resampled chunk by chunk on the way.
+template <typename Reader>
+static int renderStreaming(const std::string& modPath, const std::string& carPath, const std::string& outPath,
+                           int blockSize, const TalkBoxParams& params, RenderOptions opts, const char* mode)
+{
+    EngineInput<Reader> modIn, carIn;
+    EngineOutput out;
+    if (!openStreams(modIn, carIn, out, modPath, carPath, outPath, opts, mode)) return 1;
 
-    std::vector<float> interleavedData(totalFrames * channels);
-    drwav_read_pcm_frames_f32(&wav, totalFrames, interleavedData.data());
-    drwav_uninit(&wav);
+    TalkBoxProcessor engine;
+    engine.init(static_cast<float>(opts.engine), params);
 
-    monoData.resize(totalFrames);
-    if (channels == 1) {
-        monoData = interleavedData;
-    } else {
-        for (uint64_t i = 0; i < totalFrames; ++i) {
-            monoData[i] = interleavedData[i * channels]; // first channel
+    std::vector<float> mod(STREAM_CHUNK), car(STREAM_CHUNK), outL(STREAM_CHUNK), outR(STREAM_CHUNK);
+    for (;;)
+    {
+        // Stop with the shorter file, as the whole-file mode does
+        uint64_t modGot, carGot;
+        const float* m = modIn.next(STREAM_CHUNK, mod.data(), modGot);
+        const float* c = carIn.next(STREAM_CHUNK, car.data(), carGot);
+        uint64_t n = std::min(modGot, carGot);
+        if (n == 0) break;
+
+        for (uint64_t pos = 0; pos < n; pos += blockSize)
+        {
+            int curBlock = static_cast<int>(std::min<uint64_t>(blockSize, n - pos));
+            engine.processBlock(m + pos, c + pos, outL.data() + pos, outR.data() + pos, curBlock);
+        }
+
+        if (!out.write(outL.data(), outR.data(), n)) {
+            std::cerr << "Failed to write output WAV!\n";
+            return 1;
+        }
+        if (n < STREAM_CHUNK) break;
+    }
+    if (!out.close()) {
+        std::cerr << "Failed to write output WAV!\n";
+        return 1;
+    }
+
+    printStats(engine);
+    std::cout << "Processing done: " << out.framesWritten() << " frames written to " << outPath << "\n";
+    return 0;
+}
+
+// Two channels of STREAM_CHUNK frames: modulator/carrier on the way in,
+// left/right on the way out. A chunk shorter than STREAM_CHUNK is the last.
+struct StreamChunk {
+    uint64_t frames;
+    float a[STREAM_CHUNK];
+    float b[STREAM_CHUNK];
+};
+static constexpr uint32_t PIPELINE_DEPTH = 8;      // chunks in flight per queue
+using ChunkQueue = SpscQueue<StreamChunk, PIPELINE_DEPTH>;
+
+// Poll a queue until it hands out a slot; stages only wait on each other,
+// so yielding the core is enough
+template <typename Poll>
+static auto waitFor(Poll poll) {
+    auto slot = poll();
+    while (!slot) { std::this_thread::yield(); slot = poll(); }
+    return slot;
+}
+
+// Threaded mode: the streaming render as three stages on their own
+// threads, reader (decode) -> DSP (processBlock) -> writer (encode),
+// connected by two preallocated queues of PIPELINE_DEPTH chunks that are
+// filled and read in place. Decoding, processing and encoding of
+// successive chunks overlap. Reports the busy time of each stage (waits
+// excluded): the busiest one bounds the render, so the report shows
+// whether it is I/O-bound or DSP-bound. Resampling, when needed, is part of
+// the reader and writer stages.
+static int renderThreaded(const std::string& modPath, const std::string& carPath, const std::string& outPath,
+                          int blockSize, const TalkBoxParams& params, RenderOptions opts)
+{
+    using Clock = std::chrono::steady_clock;
+
+    EngineInput<WavMonoReader> modIn, carIn;
+    EngineOutput out;
+    if (!openStreams(modIn, carIn, out, modPath, carPath, outPath, opts, "threaded")) return 1;
+
+    TalkBoxProcessor engine;
+    engine.init(static_cast<float>(opts.engine), params);
+
+    std::unique_ptr<ChunkQueue> input(new ChunkQueue());     // reader -> DSP
+    std::unique_ptr<ChunkQueue> output(new ChunkQueue());    // DSP -> writer
+    Clock::duration readBusy{}, dspBusy{}, writeBusy{};
+    std::atomic<bool> writeFailed{false};
+
+    auto start = Clock::now();
+
+    std::thread reader([&]() {
+        for (;;)
+        {
+            StreamChunk* c = waitFor([&] { return input->writeSlot(); });
+            auto t0 = Clock::now();
+            // Stop with the shorter file, as the whole-file mode does
+            c->frames = std::min(modIn.read(c->a, STREAM_CHUNK), carIn.read(c->b, STREAM_CHUNK));
+            readBusy += Clock::now() - t0;
+            const bool last = c->frames < STREAM_CHUNK;
+            input->publish();
+            if (last) break;
+        }
+    });
+
+    std::thread writer([&]() {
+        for (;;)
+        {
+            const StreamChunk* c = waitFor([&] { return output->front(); });
+            auto t0 = Clock::now();
+            const uint64_t n = c->frames;
+            if (!writeFailed.load(std::memory_order_relaxed) && !out.write(c->a, c->b, n))
+                writeFailed.store(true, std::memory_order_relaxed);     // keep draining so the DSP never stalls
+            writeBusy += Clock::now() - t0;
+            output->release();
+            if (n < STREAM_CHUNK) break;
+        }
+    });
+
+    // DSP stage on this thread
+    for (;;)
+    {
+        const StreamChunk* in = waitFor([&] { return input->front(); });
+        StreamChunk* dst = waitFor([&] { return output->writeSlot(); });
+        auto t0 = Clock::now();
+        const uint64_t n = in->frames;
+        for (uint64_t pos = 0; pos < n; pos += blockSize)
+        {
+            int curBlock = static_cast<int>(std::min<uint64_t>(blockSize, n - pos));
+            engine.processBlock(in->a + pos, in->b + pos, dst->a + pos, dst->b + pos, curBlock);
         }
+        dst->frames = n;
+        dspBusy += Clock::now() - t0;
+        input->release();
+        output->publish();
+        if (n < STREAM_CHUNK) break;
+    }
+
+    reader.join();
+    writer.join();
+    if (!out.close()) writeFailed = true;
+    double wall = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    if (writeFailed) {
+        std::cerr << "Failed to write output WAV!\n";
+        return 1;
+    }
+
+    const std::streamsize precision = std::cout.precision();
+    auto stage = [wall](const char* name, Clock::duration busy) {
+        double ms = std::chrono::duration<double, std::milli>(busy).count();
+        std::cout << "  " << std::left << std::setw(8) << name << std::right << std::setw(9) << ms
+                  << " ms busy" << std::setw(7) << 100.0 * ms / wall << " %\n";
+    };
+    std::cout << std::fixed << std::setprecision(1) << "Stages (wall " << wall << " ms):\n";
+    stage("read",  readBusy);
+    stage("dsp",   dspBusy);
+    stage("write", writeBusy);
+    std::cout << std::defaultfloat << std::setprecision(precision);
+    Clock::duration most = std::max(readBusy, std::max(dspBusy, writeBusy));
+    std::cout << "  bound by " << (most == dspBusy ? "DSP" : (most == readBusy ? "reading" : "writing")) << "\n";
+
+    printStats(engine);
+    std::cout << "Processing done: " << out.framesWritten() << " frames written to " << outPath << "\n";
+    return 0;
+}
+
+// "<gain>,<gain>,..." of --downmix: false unless every item is a number
+static bool parseWeights(const std::string& list, std::vector<float>& weights) {
+    weights.clear();
+    for (size_t at = 0; at <= list.size(); )
+    {
+        size_t comma = std::min(list.find(',', at), list.size());
+        std::string item = list.substr(at, comma - at);
+        char* end = nullptr;
+        float gain = std::strtof(item.c_str(), &end);
+        if (item.empty() || *end != '\0' || !std::isfinite(gain)) return false;
+        weights.push_back(gain);
+        at = comma + 1;
     }
     return true;
 }
 
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program
+            << " <modulator.wav> <carrier.wav> <output.wav> <blockSize> [stream|mmap|threaded]"
+            << " [engineRate] [outputRate] [fast|normal|best]"
+            << " [--downmix=first|average|<gain>,<gain>...] [--format=f32|s16|s24]\n";
+}
+
 int main(int argc, char** argv) {
 
     std::string modPath = "mod.wav";
     std::string carPath = "car.wav";
     std::string outPath = "out.wav";
     int blockSize = 48;
+    std::string mode;
+
+    RenderOptions opts;
+
+    // --downmix=first|average|<gain>,<gain>,... and --format=f32|s16|s24 can
+    // go anywhere; the rest are positional
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string a = argv[i];
+        if (a.rfind("--downmix=", 0) == 0) {
+            std::string m = a.substr(10);
+            if (m == "first")        opts.downmix.mode = Downmix::First;
+            else if (m == "average") opts.downmix.mode = Downmix::Average;
+            else if (parseWeights(m, opts.downmix.weights)) opts.downmix.mode = Downmix::Weighted;
+            else {
+                std::cout << "Unknown --downmix value: " << m << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (a.rfind("--format=", 0) == 0) {
+            std::string f = a.substr(9);
+            if (f == "f32")      opts.format = PcmFormat::Float32;
+            else if (f == "s16") opts.format = PcmFormat::Int16;
+            else if (f == "s24") opts.format = PcmFormat::Int24;
+            else {
+                std::cout << "Unknown --format value: " << f << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            args.push_back(a);
+        }
+    }
 
-    if (argc == 5) {
-        modPath   = argv[1];
-        carPath   = argv[2];
-        outPath   = argv[3];
-        blockSize = std::stoi(argv[4]);
+    if (args.size() >= 4 && args.size() <= 8) {
+        modPath   = args[0];
+        carPath   = args[1];
+        outPath   = args[2];
+        blockSize = std::max(std::stoi(args[3]), 1);
+        mode      = (args.size() >= 5) ? args[4] : "";
+        if (args.size() >= 6) opts.engine = static_cast<uint32_t>(std::max(std::stoi(args[5]), 0));
+        if (args.size() >= 7) opts.output = static_cast<uint32_t>(std::max(std::stoi(args[6]), 0));
+        if (args.size() >= 8) {
+            const std::string& q = args[7];
+            opts.quality = (q == "fast") ? ResampleQuality::Fast : (q == "best") ? ResampleQuality::Best : ResampleQuality::Normal;
+        }
     } else {
-        std::cout << "Usage: " << argv[0]
-                << " <modulator.wav> <carrier.wav> <output.wav> <blockSize>\n";
+        printUsage(argv[0]);
         std::cout << "No arguments provided - using defaults:\n";
         std::cout << "  modulator: " << modPath << "\n"
                 << "  carrier:   " << carPath << "\n"
@@ -57,21 +453,34 @@ int main(int argc, char** argv) {
                 << "  blockSize: " << blockSize << "\n";
     }
 
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+    if (mode == "stream") return renderStreaming<WavMonoReader>(modPath, carPath, outPath, blockSize, params, opts, "streaming");
+    if (mode == "mmap")   return renderStreaming<WavMappedReader>(modPath, carPath, outPath, blockSize, params, opts, "memory-mapped");
+    if (mode == "threaded") return renderThreaded(modPath, carPath, outPath, blockSize, params, opts);
+
     // Load modulator
-    std::vector<float> modMonoData;
+    std::vector<float> modMonoData, scratch;
     unsigned int modSampleRate;
     uint64_t modTotalFrames;
-    if (!loadWavToMono(modPath.c_str(), modMonoData, modSampleRate, modTotalFrames)) return 1;
+    if (!loadWavToMono(modPath.c_str(), modMonoData, modSampleRate, modTotalFrames, scratch, opts.downmix)) return 1;
 
     // Load carrier
     std::vector<float> carMonoData;
     unsigned int carSampleRate;
     uint64_t carTotalFrames;
-    if (!loadWavToMono(carPath.c_str(), carMonoData, carSampleRate, carTotalFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), carMonoData, carSampleRate, carTotalFrames, scratch, opts.downmix)) return 1;
 
+    // Resampling is done on the fly by the streaming render: use it when
+    // the files differ, or an engine/output rate other than theirs is asked for
+    const uint32_t engineRate = opts.engine ? opts.engine : modSampleRate;
+    const uint32_t outputRate = opts.output ? opts.output : engineRate;
     if (modSampleRate != carSampleRate) {
-        std::cerr << "Sample rates must match!\n";
-        return 1;
+        std::cout << "Sample rates differ (" << modSampleRate << " / " << carSampleRate << " Hz), using streaming mode\n";
+        return renderStreaming<WavMonoReader>(modPath, carPath, outPath, blockSize, params, opts, "streaming");
+    } else if (engineRate != modSampleRate || outputRate != modSampleRate) {
+        std::cout << "Resampling " << modSampleRate << " Hz (engine " << engineRate << " Hz, output "
+                  << outputRate << " Hz), using streaming mode\n";
+        return renderStreaming<WavMonoReader>(modPath, carPath, outPath, blockSize, params, opts, "streaming");
     } else {
         std::cout << "Sample rate: " << modSampleRate << " Hz\n";
     }
@@ -83,12 +492,11 @@ int main(int argc, char** argv) {
     std::vector<float> outL(totalFrames);
     std::vector<float> outR(totalFrames);
 
-    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
     TalkBoxProcessor engine;
     engine.init(static_cast<float>(modSampleRate), params);
 
     for (uint64_t pos = 0; pos < totalFrames; pos += blockSize) {
-        int curBlock = std::min(blockSize, static_cast<int>(totalFrames - pos));
+        int curBlock = static_cast<int>(std::min<uint64_t>(blockSize, totalFrames - pos));
         engine.processBlock(modMonoData.data() + pos,
                             carMonoData.data() + pos,
                             outL.data() + pos,
@@ -96,28 +504,15 @@ int main(int argc, char** argv) {
                             curBlock);
     }
 
-    drwav_data_format fmt = {};
-    fmt.container     = drwav_container_riff;
-    fmt.format        = DR_WAVE_FORMAT_IEEE_FLOAT;
-    fmt.channels      = 2;
-    fmt.sampleRate    = modSampleRate;
-    fmt.bitsPerSample = 32;
-
-    drwav outWav;
-    if (!drwav_init_file_write(&outWav, outPath.c_str(), &fmt, nullptr)) {
-        std::cerr << "Failed to open output WAV!\n";
+    WavStereoWriter outWav;
+    if (!outWav.open(outPath.c_str(), modSampleRate, opts.format)) return 1;
+    if (outWav.write(outL.data(), outR.data(), totalFrames) != totalFrames) {
+        std::cerr << "Failed to write output WAV!\n";
         return 1;
     }
+    outWav.close();
 
-    // Interleave L/R
-    std::vector<float> interleaved(totalFrames * 2);
-    for (uint64_t i = 0; i < totalFrames; ++i) {
-        interleaved[2*i]   = outL[i];
-        interleaved[2*i+1] = outR[i];
-    }
-
-    drwav_write_pcm_frames(&outWav, totalFrames, interleaved.data());
-    drwav_uninit(&outWav);
+    printStats(engine);
 
     std::cout << "Processing done: " << totalFrames << " frames written to " << outPath << "\n";
     return 0;
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "MultiCarrierTalkBox.h"
+
+// Cost of one modulator driving M carriers with one shared analysis
+// (MultiCarrierTalkBox<M>) against M separate TalkBoxProcessor objects, for
+// M = 1, 2, 4, 8, 16. The carriers are the carrier file at M different time
+// offsets. Reports the time, the cost per carrier, the number of analyses
+// run, and the largest difference from the separate engines (set to the
+// same Direct autocorrelation, so it should be 0). A least-squares fit
+// cost = shared + M * perCarrier over the MultiCarrierTalkBox runs splits
+// the shared part (modulator path + analysis) from the per-carrier part.
+// Last, the difference for M = 4 with every engine in DenormalMode::Clamp.
+
+static constexpr int BLOCK = 48;
+
+struct Result { double ms, diff; uint32_t analyses; };
+
+template <int32_t M>
+static Result run(const std::vector<float>& mod, const std::vector<std::vector<float>>& car, float fs,
+                  const TalkBoxParams& params, double& separateMs, DenormalMode mode = DenormalMode::Flush)
+{
+    size_t total = mod.size();
+    std::vector<std::vector<float>> outL(M, std::vector<float>(total)), outR(M, std::vector<float>(total));
+    std::vector<std::vector<float>> refL(M, std::vector<float>(total)), refR(M, std::vector<float>(total));
+
+    // M separate engines
+    std::vector<std::unique_ptr<TalkBoxProcessor>> engines;
+    for (int32_t c = 0; c < M; c++)
+    {
+        engines.emplace_back(new TalkBoxProcessor());
+        engines.back()->init(fs, params);
+        engines.back()->setAutocorrMethod(AutocorrMethod::Direct);
+        engines.back()->setDenormalMode(mode);
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (int32_t c = 0; c < M; c++)
+            engines[c]->processBlock(mod.data() + pos, car[c].data() + pos, refL[c].data() + pos, refR[c].data() + pos, cur);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    separateMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    // One shared analysis
+    std::unique_ptr<MultiCarrierTalkBox<M>> shared(new MultiCarrierTalkBox<M>());
+    shared->init(fs, params);
+    shared->setDenormalMode(mode);
+    const float* carIn[M]; float* l[M]; float* r[M];
+    t0 = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < total; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, total - pos));
+        for (int32_t c = 0; c < M; c++) { carIn[c] = car[c].data() + pos; l[c] = outL[c].data() + pos; r[c] = outR[c].data() + pos; }
+        shared->processBlock(mod.data() + pos, carIn, l, r, cur);
+    }
+    t1 = std::chrono::steady_clock::now();
+
+    double diff = 0.0;
+    for (int32_t c = 0; c < M; c++)
+        for (size_t i = 0; i < total; i++) diff = std::max(diff, double(std::abs(outL[c][i] - refL[c][i])));
+    return { std::chrono::duration<double, std::milli>(t1 - t0).count(), diff, shared->analysisFrames() };
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    float sampleRate = 0.0f;        // 0 = use the file rate
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) sampleRate = std::stof(argv[3]);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [engineSampleRate]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    uint64_t totalFrames = std::min(modFrames, carFrames);
+    mod.resize(totalFrames);
+    if (sampleRate <= 0.0f) sampleRate = static_cast<float>(modRate);
+
+    // Carrier c: the carrier file rotated by c/16 of its length
+    constexpr int32_t MAX_M = 16;
+    std::vector<std::vector<float>> cars(MAX_M, std::vector<float>(totalFrames));
+    for (int32_t c = 0; c < MAX_M; c++)
+        for (uint64_t i = 0; i < totalFrames; i++) cars[c][i] = car[(i + totalFrames * c / MAX_M) % totalFrames];
+
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+    std::cout << totalFrames << " frames at " << sampleRate << " Hz, block " << BLOCK
+              << ", order " << talkbox_order(sampleRate, params.quality) << "\n\n"
+              << "   M   separate (ms)   shared (ms)   per carrier (ms)   speed-up   analyses   max |diff|\n";
+
+    const int32_t Ms[] = {1, 2, 4, 8, 16};
+    Result res[5];
+    double sep[5];
+    res[0] = run<1>(mod, cars, sampleRate, params, sep[0]);
+    res[1] = run<2>(mod, cars, sampleRate, params, sep[1]);
+    res[2] = run<4>(mod, cars, sampleRate, params, sep[2]);
+    res[3] = run<8>(mod, cars, sampleRate, params, sep[3]);
+    res[4] = run<16>(mod, cars, sampleRate, params, sep[4]);
+
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        std::cout << std::setw(4) << Ms[i] << std::fixed << std::setprecision(1)
+                  << std::setw(16) << sep[i] << std::setw(14) << res[i].ms
+                  << std::setw(19) << res[i].ms / Ms[i]
+                  << std::setw(10) << std::setprecision(2) << sep[i] / res[i].ms << "x"
+                  << std::setw(11) << res[i].analyses
+                  << std::scientific << std::setprecision(1) << std::setw(13) << res[i].diff
+                  << "\n" << std::defaultfloat;
+        sx += Ms[i]; sy += res[i].ms; sxx += double(Ms[i]) * Ms[i]; sxy += Ms[i] * res[i].ms;
+    }
+    double b = (5 * sxy - sx * sy) / (5 * sxx - sx * sx);
+    double a = (sy - b * sx) / 5;
+    std::cout << std::fixed << std::setprecision(1)
+              << "\nFit: shared " << a << " ms + " << std::setprecision(2) << b << " ms per carrier\n"
+              << std::defaultfloat;
+
+    double clampMs;
+    Result clamp = run<4>(mod, cars, sampleRate, params, clampMs, DenormalMode::Clamp);
+    std::cout << "Clamp mode, M = 4: max |diff| " << std::scientific << std::setprecision(1) << clamp.diff
+              << "\n" << std::defaultfloat;
+
+    bool ok = clamp.diff == 0.0;
+    for (int i = 0; i < 5; i++) ok = ok && res[i].diff == 0.0;
+    std::cout << (ok ? "Every carrier bit-exact with its own TalkBoxProcessor\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "ParallelRender.h"
+
+// Chunk-parallel offline render against the serial one.
+//
+// Renders the files serially through one TalkBoxProcessor, then with a
+// ParallelRenderer for 1, 2, 4, ... threads up to the number of cores, and
+// reports the time, the realtime factor, the speedup over serial and the
+// largest difference from the serial output. Then the difference for a
+// few warm-up lengths, which is what sets the tolerance. Last, the same
+// comparison in Recursive mode with the engine at 48 kHz, where the update
+// period does not divide the frame period. Fails if the default warm-up
+// is outside TOLERANCE or the frame statistics differ.
+
+static constexpr int   BLOCK     = 48;
+static constexpr float TOLERANCE = 1.0e-6f;     // max |diff| from serial, default warm-up
+
+static double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static double maxDiff(const std::vector<float>& a, const std::vector<float>& b) {
+    double d = 0.0;
+    for (size_t i = 0; i < a.size(); i++) d = std::max(d, double(std::abs(a[i] - b[i])));
+    return d;
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    int32_t repeat = 1;             // tile the files to emulate a long stem
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) repeat = std::max(std::stoi(argv[3]), 1);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [repeat]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    float fs = static_cast<float>(modRate);
+    uint64_t len = std::min(modFrames, carFrames);
+    uint64_t frames = len * repeat;
+    mod.resize(frames);
+    car.resize(frames);
+    for (uint64_t i = len; i < frames; i++) { mod[i] = mod[i - len]; car[i] = car[i - len]; }
+
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+    double audio = frames / fs;
+    int32_t cores = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), (int32_t)1);
+    std::cout << frames << " frames (" << std::fixed << std::setprecision(1) << audio << " s) at "
+              << fs << " Hz, block " << BLOCK << ", " << cores << " cores\n\n" << std::defaultfloat;
+
+    // Serial reference
+    std::vector<float> refL(frames), refR(frames);
+    TalkBoxProcessor serial;
+    serial.init(fs, params);
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t pos = 0; pos < frames; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<uint64_t>(BLOCK, frames - pos));
+        serial.processBlock(mod.data() + pos, car.data() + pos, refL.data() + pos, refR.data() + pos, cur);
+    }
+    double tSerial = seconds(t0);
+
+    auto row = [&](const std::string& name, double t, double diff) {
+        std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(9) << t << std::setprecision(1)
+                  << std::setw(10) << audio / t << std::setprecision(2) << std::setw(9) << tSerial / t
+                  << std::scientific << std::setprecision(1) << std::setw(11) << diff << "\n" << std::defaultfloat;
+    };
+    std::cout << "  render           time s  realtime  speedup   max|diff|\n";
+    row("serial", tSerial, 0.0);
+
+    bool ok = true;
+    std::vector<float> outL(frames), outR(frames);
+    for (int32_t threads = 1; ; threads = std::min(threads * 2, cores))
+    {
+        ParallelRenderer renderer(threads);
+        renderer.setBlockSize(BLOCK);
+        t0 = std::chrono::steady_clock::now();
+        renderer.render(mod.data(), car.data(), outL.data(), outR.data(), frames, fs, params);
+        double t = seconds(t0);
+        double diff = std::max(maxDiff(outL, refL), maxDiff(outR, refR));
+        row(std::to_string(threads) + (threads == 1 ? " thread" : " threads"), t, diff);
+
+        const LpcOrderStats& a = renderer.orderStats();
+        const LpcOrderStats& b = serial.orderStats();
+        ok = ok && diff <= TOLERANCE && a.frames == b.frames && a.silent == b.silent && a.orderSum == b.orderSum;
+        if (threads == cores) break;
+    }
+
+    // What the warm-up buys: difference from serial per warm-up length
+    std::cout << "\n  warm-up frames   max|diff|\n";
+    for (int32_t warmup : {0, 1, 2, 4})
+    {
+        ParallelRenderer renderer(cores);
+        renderer.setBlockSize(BLOCK);
+        renderer.setWarmupFrames(warmup);
+        renderer.render(mod.data(), car.data(), outL.data(), outR.data(), frames, fs, params);
+        std::cout << "  " << std::setw(14) << warmup << std::scientific << std::setprecision(1)
+                  << std::setw(12) << maxDiff(outL, refL) << "\n" << std::defaultfloat;
+    }
+
+    // Recursive mode at 48 kHz (the files are fed as they are): the chunks
+    // must also follow the update period of the running analysis
+    const float recFs = 48000.0f;
+    auto recursive = [](TalkBoxProcessor& e) { e.setAnalysisMode(AnalysisMode::Recursive); };
+    TalkBoxProcessor recSerial;
+    recSerial.init(recFs, params);
+    recursive(recSerial);
+    for (uint64_t pos = 0; pos < frames; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<uint64_t>(BLOCK, frames - pos));
+        recSerial.processBlock(mod.data() + pos, car.data() + pos, refL.data() + pos, refR.data() + pos, cur);
+    }
+    std::cout << "\n  Recursive at 48 kHz\n  warm-up frames   max|diff|\n";
+    for (int32_t warmup : {0, 1, 2, 4})
+    {
+        ParallelRenderer renderer(cores);
+        renderer.setBlockSize(BLOCK);
+        renderer.setWarmupFrames(warmup);
+        renderer.setConfigure(recursive);
+        renderer.render(mod.data(), car.data(), outL.data(), outR.data(), frames, recFs, params);
+        double diff = std::max(maxDiff(outL, refL), maxDiff(outR, refR));
+        std::cout << "  " << std::setw(14) << warmup << std::scientific << std::setprecision(1)
+                  << std::setw(12) << diff << "\n" << std::defaultfloat;
+        if (warmup == 4) ok = ok && diff <= TOLERANCE;
+    }
+
+    std::cout << "\n" << (ok ? "Within " : "NOT within ") << TOLERANCE << " of the serial render, same frame statistics\n";
+    return ok ? 0 : 1;
+}
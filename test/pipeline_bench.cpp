@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "LpcWorkerThread.h"
+
+// Audio-thread cost of the pipelined analysis.
+//
+// The files are processed in blocks of BLOCK samples, one block per
+// simulated audio callback, paced at real time so the worker thread runs
+// between callbacks as it would in a host. For the synchronous engine and
+// for the pipelined engine with an LpcWorkerThread, reports the mean
+// callback time, the mean of the callbacks that complete a frame (the
+// slowest ones, one per frame: the frame-boundary burst), the worst
+// callback, the frames the worker missed, and the latency added.
+// Then checks that the pipelined output does not depend on the worker: the
+// same render with no worker at all (every frame analysed as a miss) must
+// be bit-exact with the threaded one, also when the quality and gender
+// change every CHANGE_BLOCKS blocks, between a frame being queued and
+// its coefficients coming back.
+
+static constexpr int BLOCK = 48;
+static constexpr int CHANGE_BLOCKS = 37;       // parameter change period of the last check
+
+struct Timing { double mean, burst, worst; };
+
+// Render 'frames' samples, one callback per block; optionally paced at real
+// time, and with the parameters changed every CHANGE_BLOCKS blocks
+static Timing render(TalkBoxProcessor& engine, const std::vector<float>& mod, const std::vector<float>& car,
+                     std::vector<float>& out, size_t frames, float fs, bool paced, size_t boundaries,
+                     bool changing = false)
+{
+    static const float quality[] = {1.0f, 0.5f, 0.25f, 0.75f};
+    static const float gender[]  = {0.5f, 1.0f, 1.6f};
+    std::vector<float> right(frames);
+    std::vector<double> us;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < frames; pos += BLOCK)
+    {
+        if (paced)
+            std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<int64_t>(pos * 1.0e6 / fs)));
+        size_t block = pos / BLOCK;
+        if (changing && block % CHANGE_BLOCKS == 0)
+        {
+            size_t k = block / CHANGE_BLOCKS;
+            engine.updateParams({1.0f, 0.0f, quality[k % 4], gender[k % 3]});
+        }
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, frames - pos));
+        auto t0 = std::chrono::steady_clock::now();
+        engine.processBlock(mod.data() + pos, car.data() + pos, out.data() + pos, right.data() + pos, cur);
+        auto t1 = std::chrono::steady_clock::now();
+        us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    }
+    double sum = 0.0;
+    for (double t : us) sum += t;
+    std::sort(us.begin(), us.end(), std::greater<double>());
+    double burst = 0.0;
+    for (size_t i = 0; i < boundaries; i++) burst += us[i];
+    return { sum / us.size(), burst / boundaries, us[0] };
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    float seconds = 5.0f;           // length of the real-time render
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) seconds = std::stof(argv[3]);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [seconds]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    float fs = static_cast<float>(modRate);
+    size_t frames = std::min<size_t>(std::min(modFrames, carFrames), static_cast<size_t>(seconds * fs));
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.5f};   // wet, dry, quality, gender
+    std::vector<float> outSync(frames), outPipe(frames), outAlone(frames);
+
+    // Frames complete every N/2 decimated samples, i.e. every N samples
+    size_t boundaries = frames / talkbox_frame_length(fs);
+    std::cout << frames << " frames at " << fs << " Hz, block " << BLOCK << ", paced at real time, "
+              << boundaries << " LPC frames\n\n";
+
+    TalkBoxProcessor sync;
+    sync.init(fs, params);
+    Timing ts = render(sync, mod, car, outSync, frames, fs, true, boundaries);
+
+    TalkBoxProcessor piped;
+    piped.setPipelinedAnalysis(true);
+    piped.init(fs, params);
+    Timing tp;
+    {
+        LpcWorkerThread worker(piped);
+        tp = render(piped, mod, car, outPipe, frames, fs, true, boundaries);
+    }
+
+    // Same pipelined render without a worker: every frame is a miss
+    TalkBoxProcessor alone;
+    alone.setPipelinedAnalysis(true);
+    alone.init(fs, params);
+    render(alone, mod, car, outAlone, frames, fs, false, boundaries);
+    double diff = 0.0;
+    for (size_t i = 0; i < frames; i++) diff = std::max(diff, double(std::abs(outPipe[i] - outAlone[i])));
+
+    // Both again with the parameters changing under the frames in flight
+    TalkBoxProcessor changed;
+    changed.setPipelinedAnalysis(true);
+    changed.init(fs, params);
+    {
+        LpcWorkerThread worker(changed);
+        render(changed, mod, car, outPipe, frames, fs, true, boundaries, true);
+    }
+    alone.init(fs, params);
+    render(alone, mod, car, outAlone, frames, fs, false, boundaries, true);
+    double changedDiff = 0.0;
+    for (size_t i = 0; i < frames; i++) changedDiff = std::max(changedDiff, double(std::abs(outPipe[i] - outAlone[i])));
+
+    auto row = [](const char* name, const Timing& t, uint32_t misses, int32_t latency) {
+        std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(9) << t.mean << std::setw(10) << t.burst << std::setw(10) << t.worst
+                  << std::setw(9) << misses << std::setw(9) << latency << "\n" << std::defaultfloat;
+    };
+    std::cout << "  engine                 mean us  burst us  worst us   misses  latency\n";
+    row("synchronous", ts, 0, sync.analysisLatency());
+    row("pipelined + worker", tp, piped.pipelineMisses(), piped.analysisLatency());
+    std::cout << "\n  pipelined without worker: " << alone.pipelineMisses() << " misses, max |diff| from the threaded render "
+              << std::scientific << std::setprecision(1) << diff << (diff == 0.0 ? " (bit-exact)\n" : "\n");
+    std::cout << "  quality and gender changed every " << CHANGE_BLOCKS << " blocks: worker " << changed.pipelineMisses()
+              << " misses, max |diff| without worker " << changedDiff << (changedDiff == 0.0 ? " (bit-exact)\n" : "\n")
+              << std::defaultfloat;
+    return diff == 0.0 && changedDiff == 0.0 ? 0 : 1;
+}
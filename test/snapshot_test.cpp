@@ -0,0 +1,166 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "LpcWorkerThread.h"
+
+// Snapshot/restore of TalkBoxProcessor.
+//
+// For each configuration, one engine renders the whole file and saves a
+// snapshot every CHECKPOINT seconds (at block boundaries, i.e. anywhere in
+// a frame). Then, for every snapshot, a second engine that has been busy
+// with other audio restores it and renders the rest of the file, which must
+// be bit-exact with the first render. The pipelined configuration saves
+// with a worker thread running and restores without one.
+// Also reports the snapshot size, the time of a restore and the heap
+// allocations during restores (must be none), and checks that snapshots
+// from another sample rate or of the wrong size are rejected.
+
+static constexpr int   BLOCK      = 48;
+static constexpr float CHECKPOINT = 1.5f;       // seconds between snapshots
+
+// Heap allocations so far (kept out of line so the compiler does not pair
+// the inlined malloc/free with new/delete)
+static size_t heapAllocs = 0;
+__attribute__((noinline)) void* operator new(size_t size) { heapAllocs++; if (void* p = std::malloc(size)) return p; throw std::bad_alloc(); }
+__attribute__((noinline)) void* operator new[](size_t size) { return operator new(size); }
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { operator delete(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { operator delete(p); }
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+struct Config {
+    const char* name;
+    TalkBoxParams params;
+    std::function<void(TalkBoxProcessor&)> setup;     // after init()
+    bool pipelined;
+};
+
+static void render(TalkBoxProcessor& engine, const std::vector<float>& mod, const std::vector<float>& car,
+                   std::vector<float>& out, size_t from, size_t to)
+{
+    float right[BLOCK];
+    for (size_t pos = from; pos < to; pos += BLOCK)
+    {
+        int32_t cur = static_cast<int32_t>(std::min<size_t>(BLOCK, to - pos));
+        engine.processBlock(mod.data() + pos, car.data() + pos, out.data() + pos, right, cur);
+    }
+}
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav>\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    float fs = static_cast<float>(modRate);
+    size_t frames = std::min(modFrames, carFrames);
+    size_t step = (static_cast<size_t>(CHECKPOINT * fs) / BLOCK) * BLOCK;
+    std::cout << frames << " frames at " << fs << " Hz, block " << BLOCK << ", a snapshot every "
+              << step << " samples\n\n";
+
+    TalkBoxParams neutral{1.0f, 0.0f, 1.0f, 0.5f};     // wet, dry, quality, gender
+    TalkBoxParams shifted{0.8f, 0.3f, 0.6f, 0.8f};
+    std::vector<Config> configs = {
+        { "block",              neutral, nullptr, false },
+        { "block gender+df",    shifted, [](TalkBoxProcessor& e) { e.setSynthesisMethod(SynthesisMethod::DirectForm); }, false },
+        { "recursive",          neutral, [](TalkBoxProcessor& e) { e.setAnalysisMode(AnalysisMode::Recursive); }, false },
+        { "pipelined",          neutral, nullptr, true },
+    };
+
+    bool ok = true;
+    std::cout << "  config             bytes  snapshots  restore us  allocs  max|diff|\n";
+    for (const Config& c : configs)
+    {
+        auto make = [&](TalkBoxProcessor& e) {
+            e.setPipelinedAnalysis(c.pipelined);
+            e.init(fs, c.params);
+            if (c.setup) c.setup(e);
+        };
+
+        // Reference render, saving the snapshots on the way
+        TalkBoxProcessor a;
+        make(a);
+        const size_t bytes = a.snapshotSize();
+        std::vector<std::vector<uint8_t>> snaps;
+        std::vector<size_t> at;
+        std::vector<float> ref(frames);
+        {
+            std::unique_ptr<LpcWorkerThread> worker(c.pipelined ? new LpcWorkerThread(a) : nullptr);
+            for (size_t pos = 0; pos < frames; pos += step)
+            {
+                snaps.emplace_back(bytes);
+                at.push_back(pos);
+                ok = ok && a.saveSnapshot(snaps.back().data(), bytes) == bytes;
+                render(a, mod, car, ref, pos, std::min(pos + step, frames));
+            }
+        }
+
+        // Resume from each snapshot on an engine that was doing something else
+        TalkBoxProcessor b;
+        make(b);
+        std::vector<float> out(frames);
+        double diff = 0.0, us = 0.0;
+        size_t allocs = 0;
+        for (size_t s = 0; s < snaps.size(); s++)
+        {
+            render(b, car, mod, out, 0, std::min(step, frames));   // modulator and carrier swapped
+
+            size_t before = heapAllocs;
+            auto t0 = std::chrono::steady_clock::now();
+            bool restored = b.restoreSnapshot(snaps[s].data(), snaps[s].size());
+            auto t1 = std::chrono::steady_clock::now();
+            allocs += heapAllocs - before;
+            us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            ok = ok && restored;
+
+            render(b, mod, car, out, at[s], frames);
+            for (size_t i = at[s]; i < frames; i++) diff = std::max(diff, double(std::abs(out[i] - ref[i])));
+        }
+        ok = ok && diff == 0.0 && allocs == 0;
+
+        std::cout << "  " << std::left << std::setw(17) << c.name << std::right << std::setw(7) << bytes
+                  << std::setw(11) << snaps.size() << std::fixed << std::setprecision(2) << std::setw(12) << us / snaps.size()
+                  << std::setw(8) << allocs << std::scientific << std::setprecision(1) << std::setw(11) << diff
+                  << "\n" << std::defaultfloat;
+    }
+
+    // Snapshots that must be refused, leaving the engine as it was
+    TalkBoxProcessor src, other;
+    src.init(fs, neutral);
+    other.init(fs == 48000.0f ? 44100.0f : 48000.0f, neutral);
+    std::vector<uint8_t> snap(src.snapshotSize());
+    src.saveSnapshot(snap.data(), snap.size());
+    bool rejects = !other.restoreSnapshot(snap.data(), snap.size())
+                && !src.restoreSnapshot(snap.data(), snap.size() - 1)
+                && src.saveSnapshot(snap.data(), snap.size() - 1) == 0;
+    ok = ok && rejects;
+    std::cout << "\n  other sample rate / short buffer: " << (rejects ? "rejected" : "NOT rejected") << "\n";
+
+    std::cout << "\n" << (ok ? "All restored renders bit-exact\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "LpcAnalyzer.h"
+#include "LpcSynthesizer.h"
+#include "AllPassCascade.h"
+#include "DenormalGuard.h"
+
+// LpcAnalyzer and LpcSynthesizer run separately, joined by a file:
+//   1. the analyzer goes over the whole (decimated) modulator and writes
+//      one LpcFrameCoeffs per frame to a temporary file (std::tmpfile(),
+//      removed when closed)
+//   2. the file is read back, and the synthesizer filters the (pre-filtered,
+//      decimated) carrier with those records
+//   3. the result goes through the hold, post-filter and mix of
+//      TalkBoxProcessor, and must be bit-exact with its output
+// Also reports the time of each half.
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+    float sampleRate = 0.0f;        // 0 = use the file rate
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+        if (argc >= 4) sampleRate = std::stof(argv[3]);
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav> [engineSampleRate]\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    int32_t total = static_cast<int32_t>(std::min(modFrames, carFrames));
+    if (sampleRate <= 0.0f) sampleRate = static_cast<float>(modRate);
+    TalkBoxParams params{1.0f, 0.0f, 1.0f, 0.3f};   // wet, dry, quality, gender
+
+    // Reference: the composed engine
+    std::vector<float> ref(total), right(total);
+    TalkBoxProcessor engine;
+    engine.init(sampleRate, params);
+    for (int32_t pos = 0; pos < total; pos += 48)
+    {
+        int32_t cur = std::min(48, total - pos);
+        engine.processBlock(mod.data() + pos, car.data() + pos, ref.data() + pos, right.data() + pos, cur);
+    }
+
+    ScopedDenormalFlush guard;      // as in processBlock()
+
+    // The LPC runs on every other sample, starting with the second one
+    int32_t count = total / 2;
+    std::vector<float> dmod(count), dcar(count), dfx(count), filtered(total);
+    AllPassCascade<1> prefilter, postfilter;
+    prefilter.process(car.data(), filtered.data(), total);
+    for (int32_t i = 0; i < count; i++) { dmod[i] = mod[2 * i + 1]; dcar[i] = filtered[2 * i + 1]; }
+
+    // 1. Analysis to file
+    auto t0 = std::chrono::steady_clock::now();
+    LpcAnalyzer analyzer;
+    analyzer.init(sampleRate);
+    analyzer.setOrder(talkbox_order(sampleRate, params.quality));
+    analyzer.setGender(params.gender);
+    analyzer.emphasize(dmod.data(), dmod.data(), count);
+
+    FILE* f = std::tmpfile();
+    if (!f) { std::cout << "Cannot create a temporary frame file\n"; return 1; }
+    LpcFrameCoeffs frame;
+    uint32_t written = 0;
+    for (int32_t i = 0; i < count; )
+    {
+        int32_t len = std::min(count - i, analyzer.samplesToFrame());
+        if (analyzer.process(dmod.data() + i, len, frame)) { fwrite(&frame, sizeof(frame), 1, f); written++; }
+        i += len;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    // 2. Synthesis from file
+    LpcSynthesizer synth;
+    synth.init(sampleRate);
+    rewind(f);
+    for (int32_t i = 0; i < count; )
+    {
+        int32_t len = std::min(count - i, synth.samplesToFrame());
+        if (synth.process(dcar.data() + i, dfx.data() + i, len))
+        {
+            if (fread(&frame, sizeof(frame), 1, f) != 1) { std::cout << "Frame file too short\n"; fclose(f); return 1; }
+            synth.synthesize(frame);
+        }
+        i += len;
+    }
+    fclose(f);
+    auto t2 = std::chrono::steady_clock::now();
+
+    // 3. Hold over the skipped samples, post-filter, mix (wet = 1, dry = 0)
+    std::vector<float> out(total);
+    out[0] = 0.0f;
+    for (int32_t j = 1; j < total; j++) out[j] = dfx[(j - 1) >> 1];
+    postfilter.process(out.data(), out.data(), total);
+    double diff = 0.0;
+    for (int32_t j = 0; j < total; j++) diff = std::max(diff, double(std::abs(0.5f * out[j] - ref[j])));
+
+    std::cout << std::fixed << std::setprecision(2)
+              << written << " frames (" << sizeof(LpcFrameCoeffs) << " bytes each) through a temporary file\n"
+              << "  analysis  " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n"
+              << "  synthesis " << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms\n"
+              << std::scientific << std::setprecision(1)
+              << "  max |diff| from TalkBoxProcessor: " << diff << (diff == 0.0 ? "  (bit-exact)\n" : "\n");
+    return diff == 0.0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+#include "wav_utils.h"
+#include "TalkBoxProcessor.h"
+#include "StaticTalkBox.h"
+
+// Compares the firmware engine, StaticTalkBox<TalkBoxConfig<48000, 48>> with
+// the orders of src/VocoDaisy.cpp, against TalkBoxProcessor at 48 kHz with
+// the matching analysis (Block, Direct autocorrelation, Lattice synthesis).
+// The files are fed as they are, whatever their rate.
+//
+// For every instantiated order (one quality per order) and a few gender
+// settings, reports the order picked by both engines and the largest
+// difference. The only expected source of difference is the Hann window:
+// the compile-time table is correctly rounded, the runtime std::cos() may
+// be one ulp off for a few points, which moves the output by about 1e-6.
+// Fails if an order differs or a difference exceeds TOLERANCE.
+
+using Config = TalkBoxConfig<48000, 48>;
+using Engine = StaticTalkBox<Config, 4, 9, 14, 19, 23>;
+
+static constexpr float TOLERANCE = 2.0e-5f;     // max |diff| from TalkBoxProcessor
+
+int main(int argc, char** argv) {
+
+    std::string modPath = "mod.wav";
+    std::string carPath = "car.wav";
+
+    if (argc >= 3) {
+        modPath = argv[1];
+        carPath = argv[2];
+    } else {
+        std::cout << "Usage: " << argv[0] << " <modulator.wav> <carrier.wav>\n";
+        std::cout << "No arguments provided - using " << modPath << " and " << carPath << "\n";
+    }
+
+    std::vector<float> mod, car;
+    unsigned int modRate, carRate;
+    uint64_t modFrames, carFrames;
+    if (!loadWavToMono(modPath.c_str(), mod, modRate, modFrames)) return 1;
+    if (!loadWavToMono(carPath.c_str(), car, carRate, carFrames)) return 1;
+
+    // Whole blocks only: StaticTalkBox always processes Config::blockSize samples
+    const uint64_t frames = std::min(modFrames, carFrames) / Config::blockSize * Config::blockSize;
+    std::vector<float> staticL(frames), staticR(frames), refL(frames), refR(frames);
+
+    Engine* engine = new Engine();      // ~20 KB of frames, keep it off the stack
+
+    std::cout << frames << " frames, engine at " << Config::sampleRate << " Hz, block " << Config::blockSize << "\n\n";
+    std::cout << "  quality  gender  order   max|diff|\n";
+
+    bool ok = true;
+    for (float gender : {0.5f, 0.3f, 0.8f})
+    {
+        for (float quality : {0.0f, 0.25f, 0.5f, 0.75f, 1.0f})
+        {
+            TalkBoxParams params{1.0f, 0.0f, quality, gender};     // wet, dry, quality, gender
+
+            engine->init(params);
+            for (uint64_t pos = 0; pos < frames; pos += Config::blockSize)
+                engine->processBlock(mod.data() + pos, car.data() + pos, staticL.data() + pos, staticR.data() + pos);
+
+            TalkBoxProcessor reference;
+            reference.setAutocorrMethod(AutocorrMethod::Direct);
+            reference.init(Config::sampleRate, params);
+            for (uint64_t pos = 0; pos < frames; pos += Config::blockSize)
+                reference.processBlock(mod.data() + pos, car.data() + pos, refL.data() + pos, refR.data() + pos,
+                                       Config::blockSize);
+
+            double diff = 0.0;
+            for (uint64_t i = 0; i < frames; i++)
+                diff = std::max({diff, double(std::abs(staticL[i] - refL[i])), double(std::abs(staticR[i] - refR[i]))});
+
+            const int32_t order = talkbox_order(Config::sampleRate, quality);
+            std::cout << std::fixed << std::setprecision(2) << std::setw(9) << quality << std::setw(8) << gender
+                      << std::setw(7) << engine->order() << std::scientific << std::setprecision(1)
+                      << std::setw(12) << diff << (engine->order() != order ? "  order differs\n" : "\n")
+                      << std::defaultfloat;
+            ok = ok && engine->order() == order && diff <= TOLERANCE;
+        }
+    }
+    delete engine;
+
+    std::cout << "\n" << (ok ? "Within " : "NOT within ") << TOLERANCE << " of TalkBoxProcessor, same orders\n";
+    return ok ? 0 : 1;
+}
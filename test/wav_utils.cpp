@@ -0,0 +1,311 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+
+#define DR_WAV_IMPLEMENTATION
+#include "wav_utils.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+const float* WavDownmix::gains(unsigned int channels, std::vector<float>& gains) const {
+    if (channels <= 1 || mode == Downmix::First) return nullptr;
+    gains.assign(channels, 0.0f);
+    for (unsigned int c = 0; c < channels; ++c) {
+        if (mode == Downmix::Average) gains[c] = 1.0f / channels;
+        else if (c < weights.size())  gains[c] = weights[c];
+    }
+    return gains.data();
+}
+
+// Load WAV to mono float
+bool loadWavToMono(const char* path, std::vector<float>& monoData, unsigned int& sampleRate, uint64_t& totalFrames) {
+    std::vector<float> scratch;
+    return loadWavToMono(path, monoData, sampleRate, totalFrames, scratch);
+}
+
+bool loadWavToMono(const char* path, std::vector<float>& monoData, unsigned int& sampleRate, uint64_t& totalFrames,
+                   std::vector<float>& scratch, const WavDownmix& mix) {
+    drwav wav;
+    if (!drwav_init_file(&wav, path, nullptr)) {
+        std::cerr << "Failed to open WAV file: " << path << std::endl;
+        return false;
+    }
+
+    sampleRate = wav.sampleRate;
+    totalFrames = wav.totalPCMFrameCount;
+    unsigned int channels = wav.channels;
+
+    // A truncated file delivers fewer frames than its header announces;
+    // keep only those, so reused vectors never carry stale samples
+    monoData.resize(totalFrames);
+    if (channels == 1) {
+        totalFrames = drwav_read_pcm_frames_f32(&wav, totalFrames, monoData.data());
+    } else {
+        std::vector<float> gainBuf;
+        const float* gains = mix.gains(channels, gainBuf);
+        scratch.resize(WavMonoReader::WINDOW * channels);
+        uint64_t done = 0;
+        while (done < totalFrames)
+        {
+            uint64_t want = std::min<uint64_t>(WavMonoReader::WINDOW, totalFrames - done);
+            uint64_t got  = drwav_read_pcm_frames_f32(&wav, want, scratch.data());
+            deinterleave_mix(scratch.data(), channels, gains, monoData.data() + done, got);
+            done += got;
+            if (got < want) break;
+        }
+        totalFrames = done;
+    }
+    monoData.resize(totalFrames);
+    drwav_uninit(&wav);
+    return true;
+}
+
+bool WavMonoReader::open(const char* path) {
+    close();
+    if (!drwav_init_file(&wav_, path, nullptr)) {
+        std::cerr << "Failed to open WAV file: " << path << std::endl;
+        return false;
+    }
+    open_ = true;
+    if (wav_.channels > 1) window_.resize(WINDOW * wav_.channels);
+    gains_ = mix_.gains(channels(), gain_buf_);
+    return true;
+}
+
+void WavMonoReader::close() {
+    if (open_) drwav_uninit(&wav_);
+    open_ = false;
+}
+
+uint64_t WavMonoReader::read(float* mono, uint64_t frames) {
+    if (!open_) return 0;
+    const unsigned int channels = wav_.channels;
+    if (channels == 1) return drwav_read_pcm_frames_f32(&wav_, frames, mono);
+
+    uint64_t done = 0;
+    while (done < frames)
+    {
+        uint64_t want = std::min<uint64_t>(WINDOW, frames - done);
+        uint64_t got  = drwav_read_pcm_frames_f32(&wav_, want, window_.data());
+        deinterleave_mix(window_.data(), channels, gains_, mono + done, got);
+        done += got;
+        if (got < want) break;
+    }
+    return done;
+}
+
+bool WavStereoWriter::open(const char* path, unsigned int sampleRate, PcmFormat format) {
+    close();
+    drwav_data_format fmt = {};
+    fmt.container     = drwav_container_riff;
+    fmt.format        = (format == PcmFormat::Float32) ? DR_WAVE_FORMAT_IEEE_FLOAT : DR_WAVE_FORMAT_PCM;
+    fmt.channels      = 2;
+    fmt.sampleRate    = sampleRate;
+    fmt.bitsPerSample = 8 * pcm_bytes(format);
+
+    if (!drwav_init_file_write(&wav_, path, &fmt, nullptr)) {
+        std::cerr << "Failed to open output WAV: " << path << std::endl;
+        return false;
+    }
+    open_ = true;
+    format_ = format;
+    window_.resize(WINDOW * 2 * pcm_bytes(format));
+    return true;
+}
+
+void WavStereoWriter::close() {
+    if (open_) drwav_uninit(&wav_);
+    open_ = false;
+}
+
+uint64_t WavStereoWriter::write(const float* left, const float* right, uint64_t frames) {
+    if (!open_) return 0;
+    uint64_t done = 0;
+    while (done < frames)
+    {
+        uint64_t n = std::min<uint64_t>(WINDOW, frames - done);
+        switch (format_) {
+            case PcmFormat::Float32:
+                interleave_f32(left + done, right + done, reinterpret_cast<float*>(window_.data()), n);
+                break;
+            case PcmFormat::Int16:
+                interleave_s16(left + done, right + done, reinterpret_cast<int16_t*>(window_.data()), n);
+                break;
+            case PcmFormat::Int24:
+                interleave_s24(left + done, right + done, window_.data(), n);
+                break;
+        }
+        uint64_t put = drwav_write_pcm_frames(&wav_, n, window_.data());
+        done += put;
+        if (put < n) break;
+    }
+    return done;
+}
+
+bool WavMappedReader::open(const char* path) {
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER size;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        std::cerr << "Failed to open WAV file: " << path << std::endl;
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* base = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!base) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        std::cerr << "Failed to map WAV file: " << path << std::endl;
+        return false;
+    }
+    file_    = file;
+    mapping_ = mapping;
+    size_    = static_cast<uint64_t>(size.QuadPart);
+#else
+    int fd = ::open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        if (fd >= 0) ::close(fd);
+        std::cerr << "Failed to open WAV file: " << path << std::endl;
+        return false;
+    }
+    void* base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);                                // the mapping keeps the file
+    if (base == MAP_FAILED) {
+        std::cerr << "Failed to map WAV file: " << path << std::endl;
+        return false;
+    }
+    madvise(base, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    size_ = static_cast<uint64_t>(st.st_size);
+#endif
+    base_ = static_cast<const uint8_t*>(base);
+
+    if (parseFloatData()) {
+        gains_ = mix_.gains(channels_, gain_buf_);
+        return true;
+    }
+
+    // Anything else: let dr_wav decode from the mapping
+    if (!drwav_init_memory(&wav_, base_, static_cast<size_t>(size_), nullptr)) {
+        std::cerr << "Failed to open WAV file: " << path << std::endl;
+        close();
+        return false;
+    }
+    decoder_       = true;
+    sample_rate_   = wav_.sampleRate;
+    channels_      = wav_.channels;
+    total_frames_  = wav_.totalPCMFrameCount;
+    if (channels_ > 1) window_.resize(WINDOW * channels_);
+    gains_ = mix_.gains(channels_, gain_buf_);
+    return true;
+}
+
+void WavMappedReader::close() {
+    if (decoder_) drwav_uninit(&wav_);
+    decoder_ = false;
+    if (base_)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(base_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        CloseHandle(static_cast<HANDLE>(file_));
+        mapping_ = file_ = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(base_), static_cast<size_t>(size_));
+#endif
+    }
+    base_ = nullptr;
+    size_ = 0;
+    float_data_ = nullptr;
+    sample_rate_ = channels_ = 0;
+    total_frames_ = pos_ = 0;
+}
+
+// Walk the RIFF chunks: "fmt " must describe 32-bit IEEE float (plain or
+// WAVE_FORMAT_EXTENSIBLE), and "data" must start on a 4-byte boundary of
+// the mapping so it can be read as floats in place
+bool WavMappedReader::parseFloatData() {
+    auto u16 = [this](uint64_t at) { uint16_t v; memcpy(&v, base_ + at, 2); return v; };
+    auto u32 = [this](uint64_t at) { uint32_t v; memcpy(&v, base_ + at, 4); return v; };
+
+    if (size_ < 12 || memcmp(base_, "RIFF", 4) != 0 || memcmp(base_ + 8, "WAVE", 4) != 0) return false;
+
+    bool isFloat = false;
+    uint16_t channels = 0, blockAlign = 0;
+    uint32_t sampleRate = 0;
+    for (uint64_t at = 12; at + 8 <= size_; )
+    {
+        const uint8_t* id = base_ + at;
+        uint64_t bytes = u32(at + 4);
+        uint64_t body  = at + 8;
+
+        if (memcmp(id, "fmt ", 4) == 0 && bytes >= 16 && body + bytes <= size_)
+        {
+            uint16_t format = u16(body);
+            if (format == 0xFFFE && bytes >= 40) format = u16(body + 24);     // sub-format GUID
+            channels   = u16(body + 2);
+            sampleRate = u32(body + 4);
+            blockAlign = u16(body + 12);
+            isFloat    = (format == 3 && u16(body + 14) == 32 && channels > 0 && blockAlign == 4 * channels);
+        }
+        else if (memcmp(id, "data", 4) == 0)
+        {
+            if (!isFloat || (body % 4) != 0) return false;
+            bytes = std::min(bytes, size_ - body);      // streamed files may leave the size unset
+            float_data_   = reinterpret_cast<const float*>(base_ + body);
+            channels_     = channels;
+            sample_rate_  = sampleRate;
+            total_frames_ = bytes / blockAlign;
+            return true;
+        }
+        at = body + bytes + (bytes & 1);      // chunks are padded to an even size
+    }
+    return false;
+}
+
+const float* WavMappedReader::next(uint64_t frames, float* buffer, uint64_t& got) {
+    got = 0;
+    if (!base_) return buffer;
+
+    if (float_data_)
+    {
+        got = std::min(frames, total_frames_ - pos_);
+        const float* src = float_data_ + pos_ * channels_;
+        pos_ += got;
+        if (channels_ == 1) return src;         // zero-copy
+
+        deinterleave_mix(src, channels_, gains_, buffer, got);
+        return buffer;
+    }
+
+    // dr_wav decoder over the mapping
+    if (channels_ == 1) {
+        got = drwav_read_pcm_frames_f32(&wav_, frames, buffer);
+    } else {
+        while (got < frames)
+        {
+            uint64_t want = std::min<uint64_t>(WINDOW, frames - got);
+            uint64_t n    = drwav_read_pcm_frames_f32(&wav_, want, window_.data());
+            deinterleave_mix(window_.data(), channels_, gains_, buffer + got, n);
+            got += n;
+            if (n < want) break;
+        }
+    }
+    pos_ += got;
+    return buffer;
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "dr_wav.h"
+#include "SampleConvert.h"
+
+// How multichannel files are folded to mono (deinterleave_mix()). Weighted
+// takes one gain per channel, channels without one get 0. Mono files are
+// always read as they are.
+struct WavDownmix {
+    Downmix mode = Downmix::First;
+    std::vector<float> weights;
+
+    // Gains for a file of 'channels' channels, in 'gains'; nullptr when the
+    // first channel (or the only one) is copied as is
+    const float* gains(unsigned int channels, std::vector<float>& gains) const;
+};
+
+// Load WAV to mono float (first channel of multichannel files)
+bool loadWavToMono(const char* path, std::vector<float>& monoData, unsigned int& sampleRate, uint64_t& totalFrames);
+
+// Same, with a choice of downmix. Multichannel files are decoded through a
+// window of WavMonoReader::WINDOW frames in 'scratch' and mixed chunk by
+// chunk, so repeated loads into the same vectors stop allocating once they
+// are large enough
+bool loadWavToMono(const char* path, std::vector<float>& monoData, unsigned int& sampleRate, uint64_t& totalFrames,
+                   std::vector<float>& scratch, const WavDownmix& mix = WavDownmix());
+
+
+// Streaming reader: a WAV as mono float (first channel, or the downmix set
+// with setDownmix()), a few frames at a time. Multichannel files are
+// converted through a window of WINDOW frames, mono files are read straight
+// into the caller's buffer, so memory does not depend on the file length.
+class WavMonoReader {
+    public:
+        static constexpr uint64_t WINDOW = 4096;
+
+        WavMonoReader() = default;
+        ~WavMonoReader() { close(); }
+        WavMonoReader(const WavMonoReader&) = delete;
+        WavMonoReader& operator=(const WavMonoReader&) = delete;
+
+        bool open(const char* path);
+        void close();
+
+        // Downmix of multichannel files, before or after open()
+        void setDownmix(const WavDownmix& mix) { mix_ = mix; gains_ = mix_.gains(channels(), gain_buf_); }
+
+        unsigned int sampleRate() const { return wav_.sampleRate; }
+        unsigned int channels() const { return wav_.channels; }
+        uint64_t totalFrames() const { return wav_.totalPCMFrameCount; }
+
+        // Read up to 'frames' samples into 'mono'; returns the number read,
+        // fewer only at the end of the data (0 once it is reached)
+        uint64_t read(float* mono, uint64_t frames);
+
+        // Same, for callers written against WavMappedReader: the samples
+        // always land in 'buffer', which is returned
+        const float* next(uint64_t frames, float* buffer, uint64_t& got) {
+            got = read(buffer, frames);
+            return buffer;
+        }
+
+    private:
+        drwav wav_ = {};
+        bool open_ = false;
+        std::vector<float> window_;
+
+        WavDownmix mix_;
+        std::vector<float> gain_buf_;
+        const float* gains_ = nullptr;
+};
+
+// Memory-mapped reader: maps the whole file read-only and hands out the
+// first channel (or the downmix set with setDownmix()) as mono float.
+//
+// For a mono 32-bit float file the data chunk already is the array the
+// engine wants: monoData() and next() point straight into the mapping, and
+// nothing is copied or allocated. Multichannel float files are
+// de-interleaved from the mapping into the caller's buffer; any other
+// format (integer PCM, RF64, a misaligned data chunk, ...) is decoded by
+// dr_wav from the mapping through a window of WINDOW frames. Pages are only
+// read as they are touched, so opening a file costs nothing up front.
+// Assumes a little-endian host, as the WAV data is.
+class WavMappedReader {
+    public:
+        static constexpr uint64_t WINDOW = 4096;
+
+        WavMappedReader() = default;
+        ~WavMappedReader() { close(); }
+        WavMappedReader(const WavMappedReader&) = delete;
+        WavMappedReader& operator=(const WavMappedReader&) = delete;
+
+        bool open(const char* path);
+        void close();
+
+        // Downmix of multichannel files, before or after open()
+        void setDownmix(const WavDownmix& mix) { mix_ = mix; gains_ = mix_.gains(channels_, gain_buf_); }
+
+        unsigned int sampleRate() const { return sample_rate_; }
+        unsigned int channels() const { return channels_; }
+        uint64_t totalFrames() const { return total_frames_; }
+
+        // The whole file as mono samples, in the mapping; nullptr unless
+        // the file is mono 32-bit float
+        const float* monoData() const { return channels_ == 1 ? float_data_ : nullptr; }
+
+        // Next 'frames' (at most) mono samples, 'got' of them (0 at the
+        // end). Points into the mapping when the file is mono float,
+        // otherwise into 'buffer' (room for 'frames' samples), where they
+        // have been converted.
+        const float* next(uint64_t frames, float* buffer, uint64_t& got);
+
+    private:
+        bool parseFloatData();
+
+        // Mapping
+        const uint8_t* base_ = nullptr;
+        uint64_t size_ = 0;
+#if defined(_WIN32)
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+#endif
+
+        unsigned int sample_rate_ = 0;
+        unsigned int channels_ = 0;
+        uint64_t total_frames_ = 0;
+        uint64_t pos_ = 0;                      // next frame
+
+        const float* float_data_ = nullptr;     // data chunk, if 32-bit float and aligned
+        drwav wav_ = {};                        // decoder over the mapping for the other formats
+        bool decoder_ = false;
+        std::vector<float> window_;
+
+        WavDownmix mix_;
+        std::vector<float> gain_buf_;
+        const float* gains_ = nullptr;
+};
+
+// Streaming writer: stereo WAV in 32-bit float (the format of the test
+// output) or 16/24-bit integer PCM, written a few frames at a time through
+// an interleaving window of WINDOW frames (interleave_f32/s16/s24()). The
+// header is completed by close().
+class WavStereoWriter {
+    public:
+        static constexpr uint64_t WINDOW = 4096;
+
+        WavStereoWriter() = default;
+        ~WavStereoWriter() { close(); }
+        WavStereoWriter(const WavStereoWriter&) = delete;
+        WavStereoWriter& operator=(const WavStereoWriter&) = delete;
+
+        bool open(const char* path, unsigned int sampleRate, PcmFormat format = PcmFormat::Float32);
+        void close();
+
+        // Write 'frames' samples of each channel; returns the number written
+        uint64_t write(const float* left, const float* right, uint64_t frames);
+
+    private:
+        drwav wav_ = {};
+        bool open_ = false;
+        PcmFormat format_ = PcmFormat::Float32;
+        std::vector<uint8_t> window_;
+};